@@ -0,0 +1,112 @@
+/* Class for waiting for changes of redo log files and directories
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "FileNotify.h"
+#include "OracleAnalyser.h"
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    FileNotify::FileNotify(OracleAnalyser *oracleAnalyser) :
+        oracleAnalyser(oracleAnalyser),
+        fileDes(-1),
+        failed(false),
+        backoff(NOTIFY_BACKOFF_MAX),
+        watchesActive(0) {
+    }
+
+    FileNotify::~FileNotify() {
+        if (fileDes >= 0) {
+            close(fileDes);
+            fileDes = -1;
+        }
+    }
+
+    void FileNotify::drain(void) {
+        uint8_t buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+        //only the fact that something has changed is important
+        while (read(fileDes, buffer, sizeof(buffer)) > 0)
+            ;
+    }
+
+    void FileNotify::addWatch(const string &path, uint32_t mask) {
+        if ((oracleAnalyser->flags & REDO_FLAGS_NOTIFY) == 0 || failed)
+            return;
+        if (watches.find(path) != watches.end())
+            return;
+
+        if (fileDes < 0) {
+            fileDes = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fileDes < 0) {
+                WARNING("file system notifications are not available (errno = " << dec << errno << "), polling for changes");
+                failed = true;
+                return;
+            }
+        }
+
+        int watch = inotify_add_watch(fileDes, path.c_str(), mask);
+        TRACE(TRACE2_FILE, "notify watch for " << path << " returns " << dec << watch << ", errno = " << errno);
+
+        //don't retry, the path is still checked by polling
+        watches[path] = watch;
+        if (watch >= 0)
+            ++watchesActive;
+    }
+
+    void FileNotify::reset(void) {
+        backoff = NOTIFY_BACKOFF_MAX;
+    }
+
+    void FileNotify::wait(uint64_t maxSleep) {
+        if ((oracleAnalyser->flags & REDO_FLAGS_NOTIFY) == 0) {
+            usleep(maxSleep);
+            return;
+        }
+
+        //wake up on change, the timeout covers writes which are not notified (like remote writes on NFS)
+        if (watchesActive > 0) {
+            struct pollfd pollFd;
+            pollFd.fd = fileDes;
+            pollFd.events = POLLIN;
+            pollFd.revents = 0;
+
+            int ret = poll(&pollFd, 1, (maxSleep + 999) / 1000);
+            if (ret > 0)
+                drain();
+            return;
+        }
+
+        //no notifications: check often just after last change and slow down when idle
+        uint64_t sleepTime = maxSleep >> backoff;
+        if (sleepTime < NOTIFY_SLEEP_MIN)
+            sleepTime = NOTIFY_SLEEP_MIN;
+        if (sleepTime > maxSleep)
+            sleepTime = maxSleep;
+        if (backoff > 0)
+            --backoff;
+
+        usleep(sleepTime);
+    }
+}
@@ -0,0 +1,61 @@
+/* Header for FileNotify class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <map>
+#include <string>
+#include <sys/inotify.h>
+
+#include "types.h"
+
+#ifndef FILENOTIFY_H_
+#define FILENOTIFY_H_
+
+#define NOTIFY_MASK_FILE        (IN_MODIFY | IN_CLOSE_WRITE)
+#define NOTIFY_MASK_DIR         (IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO)
+#define NOTIFY_BACKOFF_MAX      4
+#define NOTIFY_SLEEP_MIN        1000
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    class OracleAnalyser;
+
+    class FileNotify {
+    protected:
+        OracleAnalyser *oracleAnalyser;
+        int fileDes;
+        bool failed;
+        uint64_t backoff;
+        map<string, int> watches;
+        uint64_t watchesActive;
+
+        void drain(void);
+
+    public:
+        FileNotify(OracleAnalyser *oracleAnalyser);
+        virtual ~FileNotify();
+
+        void addWatch(const string &path, uint32_t mask);
+        void reset(void);
+        void wait(uint64_t maxSleep);
+    };
+}
+
+#endif
@@ -0,0 +1,236 @@
+/* Header for HashMap class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <stdint.h>
+
+#include "types.h"
+#include "RuntimeException.h"
+
+#ifndef HASHMAP_H_
+#define HASHMAP_H_
+
+#define HASHMAP_MIN_SIZE        64
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    //open addressing, Robin Hood probing with backward shift deletion
+    //keys are integers (xid, objn), values are pointers or integers - nullptr or 0 means not found
+    template<typename K, typename V> class HashMap {
+    public:
+        struct Entry {
+            K key;
+            V value;
+            uint32_t dist;                  //0 - empty slot, otherwise probe distance + 1
+        };
+
+        class iterator {
+        protected:
+            Entry *pos;
+            Entry *end;
+
+        public:
+            iterator(Entry *pos, Entry *end) :
+                pos(pos),
+                end(end) {
+                while (this->pos < this->end && this->pos->dist == 0)
+                    ++this->pos;
+            }
+
+            Entry &operator*(void) {
+                return *pos;
+            }
+
+            iterator &operator++(void) {
+                ++pos;
+                while (pos < end && pos->dist == 0)
+                    ++pos;
+                return *this;
+            }
+
+            bool operator!=(const iterator &other) const {
+                return pos != other.pos;
+            }
+        };
+
+    protected:
+        Entry *entries;
+        uint64_t capacity;
+        uint64_t mask;
+        uint64_t shift;
+        uint64_t elements;
+
+        uint64_t slotOf(K key) const {
+            //Fibonacci hashing: top bits depend on all bits of xid (usn/slt/sqn), sequential objn don't collide
+            return ((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> shift;
+        }
+
+        void allocate(uint64_t newCapacity) {
+            entries = new Entry[newCapacity];
+            if (entries == nullptr) {
+                RUNTIME_FAIL("could not allocate " << dec << (newCapacity * sizeof(Entry)) << " bytes memory for (reason: hash map)");
+            }
+            for (uint64_t i = 0; i < newCapacity; ++i)
+                entries[i].dist = 0;
+            capacity = newCapacity;
+            mask = newCapacity - 1;
+            shift = 64 - __builtin_ctzll(newCapacity);
+        }
+
+        void insert(K key, V value) {
+            uint64_t pos = slotOf(key);
+            uint32_t dist = 1;
+
+            while (true) {
+                Entry &entry = entries[pos];
+                if (entry.dist == 0) {
+                    entry.key = key;
+                    entry.value = value;
+                    entry.dist = dist;
+                    ++elements;
+                    return;
+                }
+
+                //take the slot from the richer entry and continue with it
+                if (entry.dist < dist) {
+                    K keyTmp = entry.key;
+                    V valueTmp = entry.value;
+                    uint32_t distTmp = entry.dist;
+                    entry.key = key;
+                    entry.value = value;
+                    entry.dist = dist;
+                    key = keyTmp;
+                    value = valueTmp;
+                    dist = distTmp;
+                }
+
+                pos = (pos + 1) & mask;
+                ++dist;
+            }
+        }
+
+        void grow(void) {
+            Entry *oldEntries = entries;
+            uint64_t oldCapacity = capacity;
+
+            allocate(oldCapacity * 2);
+            elements = 0;
+            for (uint64_t i = 0; i < oldCapacity; ++i)
+                if (oldEntries[i].dist > 0)
+                    insert(oldEntries[i].key, oldEntries[i].value);
+            delete[] oldEntries;
+        }
+
+        int64_t findPos(K key) const {
+            uint64_t pos = slotOf(key);
+            uint32_t dist = 1;
+
+            while (true) {
+                const Entry &entry = entries[pos];
+                //an entry closer to its home slot means the key is not present
+                if (entry.dist < dist)
+                    return -1;
+                if (entry.key == key)
+                    return pos;
+
+                pos = (pos + 1) & mask;
+                ++dist;
+            }
+        }
+
+    public:
+        HashMap() :
+            entries(nullptr),
+            capacity(0),
+            mask(0),
+            shift(0),
+            elements(0) {
+            allocate(HASHMAP_MIN_SIZE);
+        }
+
+        virtual ~HashMap() {
+            delete[] entries;
+            entries = nullptr;
+        }
+
+        V get(K key) const {
+            int64_t pos = findPos(key);
+            if (pos < 0)
+                return V();
+            return entries[pos].value;
+        }
+
+        void set(K key, V value) {
+            int64_t pos = findPos(key);
+            if (pos >= 0) {
+                entries[pos].value = value;
+                return;
+            }
+
+            //keep load factor below 7/8
+            if ((elements + 1) * 8 > capacity * 7)
+                grow();
+            insert(key, value);
+        }
+
+        void erase(K key) {
+            int64_t posFound = findPos(key);
+            if (posFound < 0)
+                return;
+
+            uint64_t pos = posFound;
+            uint64_t next = (pos + 1) & mask;
+            //shift following entries back instead of leaving tombstones
+            while (entries[next].dist > 1) {
+                entries[pos].key = entries[next].key;
+                entries[pos].value = entries[next].value;
+                entries[pos].dist = entries[next].dist - 1;
+                pos = next;
+                next = (next + 1) & mask;
+            }
+            entries[pos].dist = 0;
+            --elements;
+        }
+
+        void clear(void) {
+            for (uint64_t i = 0; i < capacity; ++i)
+                entries[i].dist = 0;
+            elements = 0;
+        }
+
+        uint64_t size(void) const {
+            return elements;
+        }
+
+        uint64_t memorySize(void) const {
+            return capacity * sizeof(Entry);
+        }
+
+        iterator begin(void) {
+            return iterator(entries, entries + capacity);
+        }
+
+        iterator end(void) {
+            return iterator(entries + capacity, entries + capacity);
+        }
+    };
+}
+
+#endif
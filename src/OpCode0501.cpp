@@ -293,7 +293,7 @@ namespace OpenLogReplicator {
         }
 
         if (!oracleAnalyser->nextFieldOpt(redoLogRecord, fieldNum, fieldPos, fieldLength)) {
-            oracleAnalyser->suppLogSize += suppLogSize;
+            redoLogRecord->suppLogSize += suppLogSize;
             return;
         }
 
@@ -317,6 +317,6 @@ namespace OpenLogReplicator {
         }
 
         suppLogSize += (redoLogRecord->fieldCnt * 2 + 2 & 0xFFFC) - ((redoLogRecord->fieldCnt - suppLogFieldCnt) * 2 + 2 & 0xFFFC);
-        oracleAnalyser->suppLogSize += suppLogSize;
+        redoLogRecord->suppLogSize += suppLogSize;
     }
 }
@@ -107,7 +107,7 @@ namespace OpenLogReplicator {
             return;
         //field: 12
 
-        if (validDDL && redoLogRecord->scn > oracleAnalyser->databaseScn)
+        if (validDDL)
             redoLogRecord->objn = oracleAnalyser->read32(redoLogRecord->data + fieldPos + 0);
     }
 }
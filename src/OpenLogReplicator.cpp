@@ -30,8 +30,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "OutputBuffer.h"
 #include "ConfigurationException.h"
 #include "OracleAnalyser.h"
+#include "OracleAnalyserWorker.h"
 #include "OutputBufferJson.h"
 #include "OutputBufferProtobuf.h"
+#include "ReaderFilesystemUring.h"
 #include "RuntimeException.h"
 #include "WriterFile.h"
 #include "WriterKafka.h"
@@ -96,6 +98,22 @@ int main(int argc, char **argv) {
     Writer *writer = nullptr;
 
     try {
+        //text form of binary redo log dumps, no configuration is read: OpenLogReplicator --render-dump <file.logdump.bin> ...
+        if (argc > 2 && strcmp(argv[1], "--render-dump") == 0) {
+            oracleAnalyser = new OracleAnalyser(nullptr, "render", "render", "", "", "", "", "", "", 0, 2, 0, 1, 0, 0, READER_BATCH,
+                    0, 0, 0, 0, MEMORY_CHUNK_MIN_MB, MEMORY_CHUNK_MIN_MB, 0, 0, DISK_BUFFER_SIZE / 1024 / 1024, 0);
+            if (oracleAnalyser == nullptr) {
+                RUNTIME_FAIL("could not allocate " << dec << sizeof(OracleAnalyser) << " bytes memory for (reason: render dump)");
+            }
+
+            for (int i = 2; i < argc; ++i)
+                oracleAnalyser->addRedoLogsBatch(argv[i]);
+            oracleAnalyser->renderDumps();
+
+            delete oracleAnalyser;
+            return 0;
+        }
+
         string fileName = "OpenLogReplicator.json";
         ifstream config(fileName, ios::in);
         if (!config.is_open()) {
@@ -158,6 +176,10 @@ int main(int argc, char **argv) {
             if (sourceJSON.HasMember("flags")) {
                 const Value& flagsJSON = sourceJSON["flags"];
                 flags = flagsJSON.GetUint64();
+                //middle blocks are not read twice, checksums are the only verification for them
+                if ((flags & REDO_FLAGS_VERIFY_LAST_BLOCK) != 0 && (flags & REDO_FLAGS_BLOCK_CHECK_SUM) == 0) {
+                    CONFIG_FAIL("bad JSON, \"flags\" value 0x400 (verify last block) requires 0x40 (block checksum)");
+                }
             }
 
             //optional
@@ -203,6 +225,37 @@ int main(int argc, char **argv) {
                 checkpointInterval = checkpointIntervalJSON.GetUint64();
             }
 
+            //optional
+            uint64_t catchUpThreads = 0;
+            if (sourceJSON.HasMember("catch-up-threads")) {
+                const Value& catchUpThreadsJSON = sourceJSON["catch-up-threads"];
+                catchUpThreads = catchUpThreadsJSON.GetUint64();
+                if (catchUpThreads > CATCHUP_THREADS_MAX) {
+                    CONFIG_FAIL("bad JSON, \"catch-up-threads\" value can't be greater than " << dec << CATCHUP_THREADS_MAX);
+                }
+            }
+
+            //optional
+            uint64_t readBufferMb = DISK_BUFFER_SIZE / 1024 / 1024;
+            if (sourceJSON.HasMember("reader-buffer-mb")) {
+                const Value& readBufferMbJSON = sourceJSON["reader-buffer-mb"];
+                readBufferMb = readBufferMbJSON.GetUint64();
+                if (readBufferMb < 1 || readBufferMb > DISK_BUFFER_MAX_MB) {
+                    CONFIG_FAIL("bad JSON, \"reader-buffer-mb\" value must be between 1 and " << dec << DISK_BUFFER_MAX_MB);
+                }
+                //buffer is allocated for every archived redo log reader: current log, next log and one per catch-up thread
+                if (readBufferMb > 1 && (2 + catchUpThreads) * readBufferMb > memoryMaxMb) {
+                    CONFIG_FAIL("bad JSON, \"reader-buffer-mb\" value multiplied by (2 + \"catch-up-threads\") can't be greater than \"memory-max-mb\" value");
+                }
+            }
+
+            //optional
+            uint64_t transactionSpillMb = 0;
+            if (sourceJSON.HasMember("transaction-spill-mb")) {
+                const Value& transactionSpillMbJSON = sourceJSON["transaction-spill-mb"];
+                transactionSpillMb = transactionSpillMbJSON.GetUint64();
+            }
+
             uint64_t arch = ARCH_LOG_PATH;
             const Value& readerJSON = getJSONfield(fileName, sourceJSON, "reader");
             const Value& readerTypeJSON = getJSONfield(fileName, readerJSON, "type");
@@ -260,6 +313,21 @@ int main(int argc, char **argv) {
                 disableChecks = disableChecksJSON.GetUint64();
             }
 
+            //optional
+            uint64_t readQueueDepth = 0;
+            if (readerJSON.HasMember("queue-depth")) {
+                const Value& readQueueDepthJSON = readerJSON["queue-depth"];
+                readQueueDepth = readQueueDepthJSON.GetUint64();
+                if (readQueueDepth > URING_QUEUE_DEPTH_MAX) {
+                    CONFIG_FAIL("bad JSON, \"queue-depth\" value can't be greater than " << dec << URING_QUEUE_DEPTH_MAX);
+                }
+#ifndef LINK_LIBRARY_LIBURING
+                if (readQueueDepth > 1) {
+                    cerr << "WARNING: io_uring support is not compiled, \"queue-depth\" is ignored" << endl;
+                }
+#endif /* LINK_LIBRARY_LIBURING */
+            }
+
             const Value& nameJSON = getJSONfield(fileName, sourceJSON, "name");
 
             const char *user = "", *password = "", *server = "", *userASM = "", *passwordASM = "", *serverASM = "";
@@ -364,13 +432,23 @@ int main(int argc, char **argv) {
                 }
             }
 
+            //optional
+            uint64_t fragmentMb = 0;
+            if (formatJSON.HasMember("fragment-mb")) {
+                const Value& fragmentMbJSON = formatJSON["fragment-mb"];
+                fragmentMb = fragmentMbJSON.GetUint64();
+                if (fragmentMb > MAX_KAFKA_MESSAGE_MB) {
+                    CONFIG_FAIL("bad JSON, invalid \"fragment-mb\" value: " << dec << fragmentMb << ", expected value up to " << dec << MAX_KAFKA_MESSAGE_MB);
+                }
+            }
+
             const Value& formatTypeJSON = getJSONfield(fileName, formatJSON, "type");
 
             OutputBuffer *outputBuffer = nullptr;
             if (strcmp("json", formatTypeJSON.GetString()) == 0) {
-                outputBuffer = new OutputBufferJson(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat);
+                outputBuffer = new OutputBufferJson(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat, fragmentMb);
             } else if (strcmp("protobuf", formatTypeJSON.GetString()) == 0) {
-                outputBuffer = new OutputBufferProtobuf(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat);
+                outputBuffer = new OutputBufferProtobuf(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat, fragmentMb);
             } else {
                 CONFIG_FAIL("bad JSON, invalid \"type\" value: " << formatTypeJSON.GetString());
             }
@@ -382,7 +460,8 @@ int main(int argc, char **argv) {
 
             oracleAnalyser = new OracleAnalyser(outputBuffer, aliasJSON.GetString(), nameJSON.GetString(), user, password, server, userASM,
                     passwordASM, serverASM, arch, trace, trace2, dumpRedoLog, dumpRawData, flags, readerType, disableChecks, redoReadSleep,
-                    archReadSleep, checkpointInterval, memoryMinMb, memoryMaxMb);
+                    archReadSleep, checkpointInterval, memoryMinMb, memoryMaxMb, readQueueDepth,
+                    catchUpThreads, readBufferMb, transactionSpillMb);
             if (oracleAnalyser == nullptr) {
                 RUNTIME_FAIL("could not allocate " << dec << sizeof(OracleAnalyser) << " bytes memory for (reason: oracle analyser)");
             }
@@ -519,6 +598,11 @@ int main(int argc, char **argv) {
                     if (maxMessageMb > MAX_KAFKA_MESSAGE_MB)
                         maxMessageMb = MAX_KAFKA_MESSAGE_MB;
                 }
+                //fragment must fit in one message, otherwise forced commit would split the transaction
+                if (oracleAnalyser->outputBuffer->fragmentMb > maxMessageMb) {
+                    CONFIG_FAIL("bad JSON, invalid \"fragment-mb\" value: " << dec << oracleAnalyser->outputBuffer->fragmentMb <<
+                            ", expected value up to \"max-message-mb\" value: " << dec << maxMessageMb);
+                }
 
                 uint64_t maxMessages = 100000;
                 if (writerJSON.HasMember("max-messages")) {
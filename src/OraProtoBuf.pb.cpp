@@ -246,6 +246,8 @@ const ::PROTOBUF_NAMESPACE_ID::uint32 TableStruct_OraProtoBuf_2eproto::offsets[]
   offsetof(::OpenLogReplicator::pb::RedoDefaultTypeInternal, xid_),
   offsetof(::OpenLogReplicator::pb::RedoDefaultTypeInternal, xidn_),
   PROTOBUF_FIELD_OFFSET(::OpenLogReplicator::pb::Redo, payload_),
+  PROTOBUF_FIELD_OFFSET(::OpenLogReplicator::pb::Redo, fragment_),
+  PROTOBUF_FIELD_OFFSET(::OpenLogReplicator::pb::Redo, last_),
   PROTOBUF_FIELD_OFFSET(::OpenLogReplicator::pb::Redo, scn_val_),
   PROTOBUF_FIELD_OFFSET(::OpenLogReplicator::pb::Redo, tm_val_),
   PROTOBUF_FIELD_OFFSET(::OpenLogReplicator::pb::Redo, xid_val_),
@@ -292,25 +294,26 @@ const char descriptor_table_protodef_OraProtoBuf_2eproto[] PROTOBUF_SECTION_VARI
   "pb.Schema\022\013\n\003rid\030\003 \001(\t\022+\n\006before\030\004 \003(\0132\033"
   ".OpenLogReplicator.pb.Value\022*\n\005after\030\005 \003"
   "(\0132\033.OpenLogReplicator.pb.Value\022\013\n\003ddl\030\006"
-  " \001(\t\"\261\001\n\004Redo\022\r\n\003scn\030\001 \001(\004H\000\022\016\n\004scns\030\002 \001"
+  " \001(\t\"\321\001\n\004Redo\022\r\n\003scn\030\001 \001(\004H\000\022\016\n\004scns\030\002 \001"
   "(\tH\000\022\014\n\002tm\030\003 \001(\004H\001\022\r\n\003tms\030\004 \001(\tH\001\022\r\n\003xid"
   "\030\005 \001(\tH\002\022\016\n\004xidn\030\006 \001(\004H\002\022.\n\007payload\030\007 \003("
-  "\0132\035.OpenLogReplicator.pb.PayloadB\t\n\007scn_"
-  "valB\010\n\006tm_valB\t\n\007xid_val*H\n\002Op\022\t\n\005BEGIN\020"
-  "\000\022\n\n\006COMMIT\020\001\022\n\n\006INSERT\020\002\022\n\n\006UPDATE\020\003\022\n\n"
-  "\006DELETE\020\004\022\007\n\003DDL\020\005*\263\002\n\nColumnType\022\013\n\007UNK"
-  "NOWN\020\000\022\014\n\010VARCHAR2\020\001\022\n\n\006NUMBER\020\002\022\010\n\004LONG"
-  "\020\003\022\010\n\004DATE\020\004\022\007\n\003RAW\020\005\022\014\n\010LONG_RAW\020\006\022\t\n\005R"
-  "OWID\020\007\022\010\n\004CHAR\020\010\022\020\n\014BINARY_FLOAT\020\t\022\021\n\rBI"
-  "NARY_DOUBLE\020\n\022\010\n\004CLOB\020\013\022\010\n\004BLOB\020\014\022\r\n\tTIM"
-  "ESTAMP\020\r\022\025\n\021TIMESTAMP_WITH_TZ\020\016\022\032\n\026INTER"
-  "VAL_YEAR_TO_MONTH\020\017\022\032\n\026INTERVAL_DAY_TO_S"
-  "ECOND\020\020\022\n\n\006UROWID\020\021\022\033\n\027TIMESTAMP_WITH_LO"
-  "CAL_TZ\020\0222Z\n\013RedoService\022K\n\nredoStream\022\035."
-  "OpenLogReplicator.pb.Request\032\032.OpenLogRe"
-  "plicator.pb.Redo\"\0000\001B<\n\"io.debezium.conn"
-  "ector.oracle.protoB\021OpenLogReplicatorH\001\370"
-  "\001\001b\006proto3"
+  "\0132\035.OpenLogReplicator.pb.Payload\022\020\n\010frag"
+  "ment\030\010 \001(\004\022\014\n\004last\030\t \001(\010B\t\n\007scn_valB\010\n\006t"
+  "m_valB\t\n\007xid_val*H\n\002Op\022\t\n\005BEGIN\020\000\022\n\n\006COM"
+  "MIT\020\001\022\n\n\006INSERT\020\002\022\n\n\006UPDATE\020\003\022\n\n\006DELETE\020"
+  "\004\022\007\n\003DDL\020\005*\263\002\n\nColumnType\022\013\n\007UNKNOWN\020\000\022\014"
+  "\n\010VARCHAR2\020\001\022\n\n\006NUMBER\020\002\022\010\n\004LONG\020\003\022\010\n\004DA"
+  "TE\020\004\022\007\n\003RAW\020\005\022\014\n\010LONG_RAW\020\006\022\t\n\005ROWID\020\007\022\010"
+  "\n\004CHAR\020\010\022\020\n\014BINARY_FLOAT\020\t\022\021\n\rBINARY_DOU"
+  "BLE\020\n\022\010\n\004CLOB\020\013\022\010\n\004BLOB\020\014\022\r\n\tTIMESTAMP\020\r"
+  "\022\025\n\021TIMESTAMP_WITH_TZ\020\016\022\032\n\026INTERVAL_YEAR"
+  "_TO_MONTH\020\017\022\032\n\026INTERVAL_DAY_TO_SECOND\020\020\022"
+  "\n\n\006UROWID\020\021\022\033\n\027TIMESTAMP_WITH_LOCAL_TZ\020\022"
+  "2Z\n\013RedoService\022K\n\nredoStream\022\035.OpenLogR"
+  "eplicator.pb.Request\032\032.OpenLogReplicator"
+  ".pb.Redo\"\0000\001B<\n\"io.debezium.connector.or"
+  "acle.protoB\021OpenLogReplicatorH\001\370\001\001b\006prot"
+  "o3"
   ;
 static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor_table_OraProtoBuf_2eproto_deps[1] = {
 };
@@ -325,7 +328,7 @@ static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_Ora
 };
 static ::PROTOBUF_NAMESPACE_ID::internal::once_flag descriptor_table_OraProtoBuf_2eproto_once;
 const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_OraProtoBuf_2eproto = {
-  false, false, descriptor_table_protodef_OraProtoBuf_2eproto, "OraProtoBuf.proto", 1570,
+  false, false, descriptor_table_protodef_OraProtoBuf_2eproto, "OraProtoBuf.proto", 1602,
   &descriptor_table_OraProtoBuf_2eproto_once, descriptor_table_OraProtoBuf_2eproto_sccs, descriptor_table_OraProtoBuf_2eproto_deps, 7, 0,
   schemas, file_default_instances, TableStruct_OraProtoBuf_2eproto::offsets,
   file_level_metadata_OraProtoBuf_2eproto, 7, file_level_enum_descriptors_OraProtoBuf_2eproto, file_level_service_descriptors_OraProtoBuf_2eproto,
@@ -2514,6 +2517,9 @@ Redo::Redo(const Redo& from)
   : ::PROTOBUF_NAMESPACE_ID::Message(),
       payload_(from.payload_) {
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&fragment_, &from.fragment_,
+    static_cast<size_t>(reinterpret_cast<char*>(&last_) -
+    reinterpret_cast<char*>(&fragment_)) + sizeof(last_));
   clear_has_scn_val();
   switch (from.scn_val_case()) {
     case kScn: {
@@ -2561,6 +2567,9 @@ Redo::Redo(const Redo& from)
 
 void Redo::SharedCtor() {
   ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_Redo_OraProtoBuf_2eproto.base);
+  ::memset(&fragment_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&last_) -
+      reinterpret_cast<char*>(&fragment_)) + sizeof(last_));
   clear_has_scn_val();
   clear_has_tm_val();
   clear_has_xid_val();
@@ -2662,6 +2671,9 @@ void Redo::Clear() {
   (void) cached_has_bits;
 
   payload_.Clear();
+  ::memset(&fragment_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&last_) -
+      reinterpret_cast<char*>(&fragment_)) + sizeof(last_));
   clear_scn_val();
   clear_tm_val();
   clear_xid_val();
@@ -2736,6 +2748,20 @@ const char* Redo::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::inter
           } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<58>(ptr));
         } else goto handle_unusual;
         continue;
+      // uint64 fragment = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 64)) {
+          fragment_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
+      // bool last = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 72)) {
+          last_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
       default: {
       handle_unusual:
         if ((tag & 7) == 4 || tag == 0) {
@@ -2820,6 +2846,18 @@ failure:
       InternalWriteMessage(7, this->_internal_payload(i), target, stream);
   }
 
+  // uint64 fragment = 8;
+  if (this->fragment() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteUInt64ToArray(8, this->_internal_fragment(), target);
+  }
+
+  // bool last = 9;
+  if (this->last() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(9, this->_internal_last(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -2843,6 +2881,18 @@ size_t Redo::ByteSizeLong() const {
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
   }
 
+  // uint64 fragment = 8;
+  if (this->fragment() != 0) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::UInt64Size(
+        this->_internal_fragment());
+  }
+
+  // bool last = 9;
+  if (this->last() != 0) {
+    total_size += 1 + 1;
+  }
+
   switch (scn_val_case()) {
     // uint64 scn = 1;
     case kScn: {
@@ -2932,6 +2982,12 @@ void Redo::MergeFrom(const Redo& from) {
   (void) cached_has_bits;
 
   payload_.MergeFrom(from.payload_);
+  if (from.fragment() != 0) {
+    _internal_set_fragment(from._internal_fragment());
+  }
+  if (from.last() != 0) {
+    _internal_set_last(from._internal_last());
+  }
   switch (from.scn_val_case()) {
     case kScn: {
       _internal_set_scn(from._internal_scn());
@@ -2995,6 +3051,12 @@ void Redo::InternalSwap(Redo* other) {
   using std::swap;
   _internal_metadata_.Swap<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(&other->_internal_metadata_);
   payload_.InternalSwap(&other->payload_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Redo, last_)
+      + sizeof(Redo::last_)
+      - PROTOBUF_FIELD_OFFSET(Redo, fragment_)>(
+          reinterpret_cast<char*>(&fragment_),
+          reinterpret_cast<char*>(&other->fragment_));
   swap(scn_val_, other->scn_val_);
   swap(tm_val_, other->tm_val_);
   swap(xid_val_, other->xid_val_);
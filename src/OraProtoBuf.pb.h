@@ -1575,6 +1575,8 @@ class Redo PROTOBUF_FINAL :
 
   enum : int {
     kPayloadFieldNumber = 7,
+    kFragmentFieldNumber = 8,
+    kLastFieldNumber = 9,
     kScnFieldNumber = 1,
     kScnsFieldNumber = 2,
     kTmFieldNumber = 3,
@@ -1600,6 +1602,24 @@ class Redo PROTOBUF_FINAL :
   const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::OpenLogReplicator::pb::Payload >&
       payload() const;
 
+  // uint64 fragment = 8;
+  void clear_fragment();
+  ::PROTOBUF_NAMESPACE_ID::uint64 fragment() const;
+  void set_fragment(::PROTOBUF_NAMESPACE_ID::uint64 value);
+  private:
+  ::PROTOBUF_NAMESPACE_ID::uint64 _internal_fragment() const;
+  void _internal_set_fragment(::PROTOBUF_NAMESPACE_ID::uint64 value);
+  public:
+
+  // bool last = 9;
+  void clear_last();
+  bool last() const;
+  void set_last(bool value);
+  private:
+  bool _internal_last() const;
+  void _internal_set_last(bool value);
+  public:
+
   // uint64 scn = 1;
   private:
   bool _internal_has_scn() const;
@@ -1722,6 +1742,8 @@ class Redo PROTOBUF_FINAL :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::OpenLogReplicator::pb::Payload > payload_;
+  ::PROTOBUF_NAMESPACE_ID::uint64 fragment_;
+  bool last_;
   union ScnValUnion {
     ScnValUnion() {}
     ::PROTOBUF_NAMESPACE_ID::uint64 scn_;
@@ -3692,6 +3714,46 @@ Redo::payload() const {
   return payload_;
 }
 
+// uint64 fragment = 8;
+inline void Redo::clear_fragment() {
+  fragment_ = PROTOBUF_ULONGLONG(0);
+}
+inline ::PROTOBUF_NAMESPACE_ID::uint64 Redo::_internal_fragment() const {
+  return fragment_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::uint64 Redo::fragment() const {
+  // @@protoc_insertion_point(field_get:OpenLogReplicator.pb.Redo.fragment)
+  return _internal_fragment();
+}
+inline void Redo::_internal_set_fragment(::PROTOBUF_NAMESPACE_ID::uint64 value) {
+  
+  fragment_ = value;
+}
+inline void Redo::set_fragment(::PROTOBUF_NAMESPACE_ID::uint64 value) {
+  _internal_set_fragment(value);
+  // @@protoc_insertion_point(field_set:OpenLogReplicator.pb.Redo.fragment)
+}
+
+// bool last = 9;
+inline void Redo::clear_last() {
+  last_ = false;
+}
+inline bool Redo::_internal_last() const {
+  return last_;
+}
+inline bool Redo::last() const {
+  // @@protoc_insertion_point(field_get:OpenLogReplicator.pb.Redo.last)
+  return _internal_last();
+}
+inline void Redo::_internal_set_last(bool value) {
+  
+  last_ = value;
+}
+inline void Redo::set_last(bool value) {
+  _internal_set_last(value);
+  // @@protoc_insertion_point(field_set:OpenLogReplicator.pb.Redo.last)
+}
+
 inline bool Redo::has_scn_val() const {
   return scn_val_case() != SCN_VAL_NOT_SET;
 }
@@ -29,12 +29,16 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "DatabaseStatement.h"
 #include "OracleAnalyser.h"
 #include "OracleAnalyserRedoLog.h"
+#include "OracleAnalyserWorker.h"
 #include "OracleColumn.h"
 #include "OracleObject.h"
 #include "OutputBuffer.h"
 #include "Reader.h"
 #include "ReaderASM.h"
+#include "ReaderCompressed.h"
 #include "ReaderFilesystem.h"
+#include "ReaderFilesystemUring.h"
+#include "ReaderMmap.h"
 #include "RedoLogException.h"
 #include "RedoLogRecord.h"
 #include "RuntimeException.h"
@@ -151,7 +155,8 @@ namespace OpenLogReplicator {
     OracleAnalyser::OracleAnalyser(OutputBuffer *outputBuffer, const char *alias, const char *database, const char *user, const char *password,
             const char *connectString, const char *userASM, const char *passwordASM, const char *connectStringASM, uint64_t arch, uint64_t trace,
             uint64_t trace2, uint64_t dumpRedoLog, uint64_t dumpRawData, uint64_t flags, uint64_t readerType, uint64_t disableChecks,
-            uint64_t redoReadSleep, uint64_t archReadSleep, uint64_t checkpointInterval, uint64_t memoryMinMb, uint64_t memoryMaxMb) :
+            uint64_t redoReadSleep, uint64_t archReadSleep, uint64_t checkpointInterval, uint64_t memoryMinMb, uint64_t memoryMaxMb,
+            uint64_t readQueueDepth, uint64_t catchUpThreads, uint64_t readBufferMb, uint64_t transactionSpillMb) :
         Thread(alias),
         databaseSequence(0),
         user(user),
@@ -162,8 +167,13 @@ namespace OpenLogReplicator {
         connectStringASM(connectStringASM),
         database(database),
         archReader(nullptr),
-        rolledBack1(nullptr),
-        rolledBack2(nullptr),
+        archReaderNext(nullptr),
+        archRedoNext(nullptr),
+        catchUpWorkers(nullptr),
+        rollbackListOldest(nullptr),
+        rollbackListNewest(nullptr),
+        rollbackListFree(nullptr),
+        rollbackListChunks(nullptr),
         suppLogDbPrimary(0),
         suppLogDbAll(0),
         previousCheckpoint(clock()),
@@ -177,13 +187,19 @@ namespace OpenLogReplicator {
         memoryChunksMax(memoryMaxMb / MEMORY_CHUNK_SIZE_MB),
         memoryChunksHWM(0),
         memoryChunksSupplemental(0),
+        memoryChunksReserved(0),
+        seekScn(ZERO_SCN),
+        indexSequence(0),
         object(nullptr),
+        notify(this),
         env(nullptr),
         conn(nullptr),
         connASM(nullptr),
         waitingForWriter(false),
         databaseContext(""),
         databaseScn(0),
+        rollbackKeysCnt(0),
+        rollbackIndexChunks(0),
         lastOpTransactionMap(nullptr),
         transactionHeap(nullptr),
         transactionBuffer(nullptr),
@@ -195,6 +211,10 @@ namespace OpenLogReplicator {
         disableChecks(disableChecks),
         redoReadSleep(redoReadSleep),
         archReadSleep(archReadSleep),
+        readQueueDepth(readQueueDepth),
+        catchUpThreads(catchUpThreads),
+        readBufferMb(readBufferMb),
+        transactionSpillMb(transactionSpillMb),
         arch(arch),
         trace(trace),
         trace2(trace2),
@@ -202,19 +222,11 @@ namespace OpenLogReplicator {
         conId(0),
         resetlogs(0),
         activation(0),
-        isBigEndian(false),
-        suppLogSize(0),
-        read16(read16Little),
-        read32(read32Little),
-        read56(read56Little),
-        read64(read64Little),
-        readSCN(readSCNLittle),
-        readSCNr(readSCNrLittle),
-        write16(write16Little),
-        write32(write32Little),
-        write56(write56Little),
-        write64(write64Little),
-        writeSCN(writeSCNLittle) {
+        isBigEndian(false) {
+
+        //binary dump captures raw records, vectors are not formatted on analyser thread
+        if ((flags & REDO_FLAGS_DUMP_BINARY) != 0)
+            this->dumpRedoLog = 0;
 
         memoryChunks = new uint8_t*[memoryMaxMb / MEMORY_CHUNK_SIZE_MB];
         if (memoryChunks == nullptr) {
@@ -258,6 +270,7 @@ namespace OpenLogReplicator {
             delete object;
             object = nullptr;
         }
+        catchUpDropAll();
         readerDropAll();
         freeRollbackList();
 
@@ -272,14 +285,14 @@ namespace OpenLogReplicator {
         onlineRedoSet.clear();
 
         partitionMap.clear();
-        for (auto it : objectMap) {
-            OracleObject *objectTmp = it.second;
+        for (auto &entry : objectMap) {
+            OracleObject *objectTmp = entry.value;
             delete objectTmp;
         }
         objectMap.clear();
 
-        for (auto it : xidTransactionMap) {
-            Transaction *transaction = it.second;
+        for (auto &entry : xidTransactionMap) {
+            Transaction *transaction = entry.value;
             delete transaction;
         }
         xidTransactionMap.clear();
@@ -385,6 +398,14 @@ namespace OpenLogReplicator {
         if (minSequence == 0xFFFFFFFF)
             minSequence = databaseSequence;
 
+        //position in first sequence where reading can start after restart
+        typescn firstScn = databaseScn;
+        for (uint64_t i = 1; i <= transactionHeap->size; ++i) {
+            transaction = transactionHeap->at(i);
+            if (transaction->firstSequence == minSequence && transaction->firstScn < firstScn)
+                firstScn = transaction->firstScn;
+        }
+
         uint64_t timeSinceCheckpoint = (now - previousCheckpoint) / CLOCKS_PER_SEC;
 
         FULL_("writing checkpoint information scn: " << PRINTSCN64(databaseScn) <<
@@ -403,12 +424,23 @@ namespace OpenLogReplicator {
         ss << "{\"database\":\"" << database
                 << "\",\"sequence\":" << dec << minSequence
                 << ",\"scn\":" << dec << databaseScn
+                << ",\"first-scn\":" << dec << firstScn
                 << ",\"resetlogs\":" << dec << resetlogs
                 << ",\"activation\":" << dec << activation << "}";
 
         outfile << ss.rdbuf();
         outfile.close();
 
+        //redo log indexes before checkpoint are not needed any more
+        if ((flags & REDO_FLAGS_INDEX) != 0) {
+            if (indexSequence == 0)
+                indexSequence = minSequence;
+            while (indexSequence < minSequence) {
+                unlink(getIndexFileName(indexSequence).c_str());
+                ++indexSequence;
+            }
+        }
+
         if (atShutdown) {
             INFO_("writing checkpoint at exit for " << database << ":" <<
                         " scn: " << dec << databaseScn <<
@@ -467,18 +499,24 @@ namespace OpenLogReplicator {
         const Value& scnJSON = getJSONfield(fileName, document, "scn");
         databaseScn = scnJSON.GetUint64();
 
+        //optional
+        if (document.HasMember("first-scn")) {
+            const Value& firstScnJSON = document["first-scn"];
+            seekScn = firstScnJSON.GetUint64();
+        }
+
         infile.close();
     }
 
     void OracleAnalyser::addToDict(OracleObject *object) {
-        if (objectMap[object->objn] == nullptr) {
-            objectMap[object->objn] = object;
+        if (objectMap.get(object->objn) == nullptr) {
+            objectMap.set(object->objn, object);
         } else {
             CONFIG_FAIL("can't add object objn: " << dec << object->objn << ", objd: " << object->objd << " - another object with the same id");
         }
 
-        if (partitionMap[object->objn] == nullptr) {
-            partitionMap[object->objn] = object;
+        if (partitionMap.get(object->objn) == nullptr) {
+            partitionMap.set(object->objn, object);
         } else {
             CONFIG_FAIL("can't add object objn: " << dec << object->objn << ", objd: " << object->objn << " - another object with the same id");
         }
@@ -487,8 +525,8 @@ namespace OpenLogReplicator {
             typeobj partitionObjn = objx >> 32;
             typeobj partitionObjd = objx & 0xFFFFFFFF;
 
-            if (partitionMap[partitionObjn] == nullptr) {
-                partitionMap[partitionObjn] = object;
+            if (partitionMap.get(partitionObjn) == nullptr) {
+                partitionMap.set(partitionObjn, object);
             } else {
                 CONFIG_FAIL("can't add object objn: " << dec << partitionObjn << ", objd: " << partitionObjd << " - another object with the same id");
             }
@@ -593,6 +631,8 @@ namespace OpenLogReplicator {
             if ((dir = opendir(mappedPath.c_str())) == nullptr) {
                 RUNTIME_FAIL("can't access directory: " << mappedPath);
             }
+            if ((flags & REDO_FLAGS_ARCH_ONLY) != 0)
+                notify.addWatch(mappedPath, NOTIFY_MASK_DIR);
 
             string newLastCheckedDay;
             struct dirent *ent;
@@ -622,6 +662,8 @@ namespace OpenLogReplicator {
                     closedir(dir);
                     RUNTIME_FAIL("can't access directory: " << mappedPathWithFile);
                 }
+                if ((flags & REDO_FLAGS_ARCH_ONLY) != 0)
+                    notify.addWatch(mappedPathWithFile, NOTIFY_MASK_DIR);
 
                 struct dirent *ent2;
                 while ((ent2 = readdir(dir2)) != nullptr) {
@@ -706,6 +748,8 @@ namespace OpenLogReplicator {
                     if ((dir = opendir(mappedPath.c_str())) == nullptr) {
                         RUNTIME_FAIL("can't access directory: " << mappedPath);
                     }
+                    if ((flags & REDO_FLAGS_ARCH_ONLY) != 0)
+                        notify.addWatch(mappedPath, NOTIFY_MASK_DIR);
 
                     struct dirent *ent;
                     while ((ent = readdir(dir)) != nullptr) {
@@ -738,224 +782,113 @@ namespace OpenLogReplicator {
         }
     }
 
-    void OracleAnalyser::updateOnlineLogs(void) {
-        for (OracleAnalyserRedoLog *oracleAnalyserRedoLog : onlineRedoSet) {
-            oracleAnalyserRedoLog->resetRedo();
-            if (!readerUpdateRedoLog(oracleAnalyserRedoLog->reader)) {
-                RUNTIME_FAIL("updating failed for " << dec << oracleAnalyserRedoLog->path);
-            } else {
-                oracleAnalyserRedoLog->sequence = oracleAnalyserRedoLog->reader->sequence;
-                oracleAnalyserRedoLog->firstScn = oracleAnalyserRedoLog->reader->firstScn;
-                oracleAnalyserRedoLog->nextScn = oracleAnalyserRedoLog->reader->nextScn;
-            }
-        }
-    }
-
-    uint16_t OracleAnalyser::read16Little(const uint8_t* buf) {
-        return (uint16_t)buf[0] | ((uint16_t)buf[1] << 8);
-    }
+    uint64_t OracleAnalyser::archCatchUp(void) {
+        uint64_t ret = REDO_FINISHED;
+        typeseq nextSequence = databaseSequence;
 
-    uint16_t OracleAnalyser::read16Big(const uint8_t* buf) {
-        return ((uint16_t)buf[0] << 8) | (uint16_t)buf[1];
-    }
-
-    uint32_t OracleAnalyser::read32Little(const uint8_t* buf) {
-        return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
-                ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
-    }
-
-    uint32_t OracleAnalyser::read32Big(const uint8_t* buf) {
-        return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
-                ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
-    }
-
-    uint64_t OracleAnalyser::read56Little(const uint8_t* buf) {
-        return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
-                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
-                ((uint64_t)buf[4] << 32) | ((uint64_t)buf[5] << 40) |
-                ((uint64_t)buf[6] << 48);
-    }
-
-    uint64_t OracleAnalyser::read56Big(const uint8_t* buf) {
-        return (((uint64_t)buf[0] << 24) | ((uint64_t)buf[1] << 16) |
-                ((uint64_t)buf[2] << 8) | ((uint64_t)buf[3]) |
-                ((uint64_t)buf[4] << 40) | ((uint64_t)buf[5] << 32) |
-                ((uint64_t)buf[6] << 48));
-    }
-
-    uint64_t OracleAnalyser::read64Little(const uint8_t* buf) {
-        return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
-                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
-                ((uint64_t)buf[4] << 32) | ((uint64_t)buf[5] << 40) |
-                ((uint64_t)buf[6] << 48) | ((uint64_t)buf[7] << 56);
-    }
-
-    uint64_t OracleAnalyser::read64Big(const uint8_t* buf) {
-        return ((uint64_t)buf[0] << 56) | ((uint64_t)buf[1] << 48) |
-                ((uint64_t)buf[2] << 40) | ((uint64_t)buf[3] << 32) |
-                ((uint64_t)buf[4] << 24) | ((uint64_t)buf[5] << 16) |
-                ((uint64_t)buf[6] << 8) | (uint64_t)buf[7];
-    }
+        if (catchUpWorkers == nullptr) {
+            catchUpWorkers = new OracleAnalyserWorker*[catchUpThreads];
+            if (catchUpWorkers == nullptr) {
+                RUNTIME_FAIL("could not allocate " << dec << (sizeof(OracleAnalyserWorker*) * catchUpThreads) << " bytes memory for (reason: catch-up workers)");
+            }
+            memset(catchUpWorkers, 0, sizeof(OracleAnalyserWorker*) * catchUpThreads);
 
-    typescn OracleAnalyser::readSCNLittle(const uint8_t* buf) {
-        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
-            return ZERO_SCN;
-        if ((buf[5] & 0x80) == 0x80)
-            return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
-                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
-                ((uint64_t)buf[6] << 32) | ((uint64_t)buf[7] << 40) |
-                ((uint64_t)buf[4] << 48) | ((uint64_t)(buf[5] & 0x7F) << 56);
-        else
-            return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
-                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
-                ((uint64_t)buf[4] << 32) | ((uint64_t)buf[5] << 40);
-    }
+            for (uint64_t i = 0; i < catchUpThreads; ++i) {
+                Reader *reader = readerCreate(0);
+                catchUpWorkers[i] = new OracleAnalyserWorker(alias.c_str(), this, reader);
+                if (catchUpWorkers[i] == nullptr) {
+                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OracleAnalyserWorker) << " bytes memory for (reason: catch-up worker)");
+                }
 
-    typescn OracleAnalyser::readSCNBig(const uint8_t* buf) {
-        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
-            return ZERO_SCN;
-        if ((buf[4] & 0x80) == 0x80)
-            return (uint64_t)buf[3] | ((uint64_t)buf[2] << 8) |
-                ((uint64_t)buf[1] << 16) | ((uint64_t)buf[0] << 24) |
-                ((uint64_t)buf[7] << 32) | ((uint64_t)buf[6] << 40) |
-                ((uint64_t)buf[5] << 48) | ((uint64_t)(buf[4] & 0x7F) << 56);
-        else
-            return (uint64_t)buf[3] | ((uint64_t)buf[2] << 8) |
-                ((uint64_t)buf[1] << 16) | ((uint64_t)buf[0] << 24) |
-                ((uint64_t)buf[5] << 32) | ((uint64_t)buf[4] << 40);
-    }
+                if (pthread_create(&catchUpWorkers[i]->pthread, nullptr, &Thread::runStatic, (void*)catchUpWorkers[i])) {
+                    CONFIG_FAIL("spawning thread");
+                }
+            }
+        }
 
-    typescn OracleAnalyser::readSCNrLittle(const uint8_t* buf) {
-        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
-            return ZERO_SCN;
-        if ((buf[1] & 0x80) == 0x80)
-            return (uint64_t)buf[2] | ((uint64_t)buf[3] << 8) |
-                ((uint64_t)buf[4] << 16) | ((uint64_t)buf[5] << 24) |
-                //((uint64_t)buf[6] << 32) | ((uint64_t)buf[7] << 40) |
-                ((uint64_t)buf[0] << 48) | ((uint64_t)(buf[1] & 0x7F) << 56);
-        else
-            return (uint64_t)buf[2] | ((uint64_t)buf[3] << 8) |
-                ((uint64_t)buf[4] << 16) | ((uint64_t)buf[5] << 24) |
-                ((uint64_t)buf[0] << 32) | ((uint64_t)buf[1] << 40);
-    }
+        while (!shutdown) {
+            //start decoding of next redo logs, every worker gets one file
+            while (catchUpRedoQueue.size() < catchUpThreads && !archiveRedoQueue.empty() &&
+                    archiveRedoQueue.top()->sequence == nextSequence) {
+                OracleAnalyserRedoLog *redo = archiveRedoQueue.top();
+                archiveRedoQueue.pop();
+
+                while (!archiveRedoQueue.empty() && archiveRedoQueue.top()->sequence == redo->sequence) {
+                    OracleAnalyserRedoLog *redoTmp = archiveRedoQueue.top();
+                    archiveRedoQueue.pop();
+                    delete redoTmp;
+                }
 
-    typescn OracleAnalyser::readSCNrBig(const uint8_t* buf) {
-        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
-            return ZERO_SCN;
-        if ((buf[0] & 0x80) == 0x80)
-            return (uint64_t)buf[5] | ((uint64_t)buf[4] << 8) |
-                ((uint64_t)buf[3] << 16) | ((uint64_t)buf[2] << 24) |
-                //((uint64_t)buf[7] << 32) | ((uint64_t)buf[6] << 40) |
-                ((uint64_t)buf[1] << 48) | ((uint64_t)(buf[0] & 0x7F) << 56);
-        else
-            return (uint64_t)buf[5] | ((uint64_t)buf[4] << 8) |
-                ((uint64_t)buf[3] << 16) | ((uint64_t)buf[2] << 24) |
-                ((uint64_t)buf[1] << 32) | ((uint64_t)buf[0] << 40);
-    }
+                TRACE_(TRACE2_REDO, "catch-up decoding of sequence: " << dec << redo->sequence);
+                catchUpRedoQueue.push(redo);
+                catchUpWorkers[redo->sequence % catchUpThreads]->assign(redo);
+                ++nextSequence;
+            }
 
-    void OracleAnalyser::write16Little(uint8_t* buf, uint16_t val) {
-        buf[0] = val & 0xFF;
-        buf[1] = (val >> 8) & 0xFF;
-    }
+            if (catchUpRedoQueue.empty())
+                break;
 
-    void OracleAnalyser::write16Big(uint8_t* buf, uint16_t val) {
-        buf[0] = (val >> 8) & 0xFF;
-        buf[1] = val & 0xFF;
-    }
+            //transactions are updated in sequence order
+            OracleAnalyserRedoLog *redo = catchUpRedoQueue.front();
+            redo->resetRedo();
+            ret = redo->replayLog(catchUpWorkers[redo->sequence % catchUpThreads]);
 
-    void OracleAnalyser::write32Little(uint8_t* buf, uint32_t val) {
-        buf[0] = val & 0xFF;
-        buf[1] = (val >> 8) & 0xFF;
-        buf[2] = (val >> 16) & 0xFF;
-        buf[3] = (val >> 24) & 0xFF;
-    }
+            if (shutdown)
+                break;
 
-    void OracleAnalyser::write32Big(uint8_t* buf, uint32_t val) {
-        buf[0] = (val >> 24) & 0xFF;
-        buf[1] = (val >> 16) & 0xFF;
-        buf[2] = (val >> 8) & 0xFF;
-        buf[3] = val & 0xFF;
-    }
+            if (ret != REDO_FINISHED) {
+                RUNTIME_FAIL("archive log processing returned: " << dec << ret);
+            }
 
-    void OracleAnalyser::write56Little(uint8_t* buf, uint64_t val) {
-        buf[0] = val & 0xFF;
-        buf[1] = (val >> 8) & 0xFF;
-        buf[2] = (val >> 16) & 0xFF;
-        buf[3] = (val >> 24) & 0xFF;
-        buf[4] = (val >> 32) & 0xFF;
-        buf[5] = (val >> 40) & 0xFF;
-        buf[6] = (val >> 48) & 0xFF;
-    }
+            catchUpRedoQueue.pop();
+            ++databaseSequence;
+            writeCheckpoint(false);
+            delete redo;
+        }
 
-    void OracleAnalyser::write56Big(uint8_t* buf, uint64_t val) {
-        buf[0] = (val >> 48) & 0xFF;
-        buf[1] = (val >> 40) & 0xFF;
-        buf[2] = (val >> 32) & 0xFF;
-        buf[3] = (val >> 24) & 0xFF;
-        buf[4] = (val >> 16) & 0xFF;
-        buf[5] = (val >> 8) & 0xFF;
-        buf[6] = val & 0xFF;
+        return ret;
     }
 
-    void OracleAnalyser::write64Little(uint8_t* buf, uint64_t val) {
-        buf[0] = val & 0xFF;
-        buf[1] = (val >> 8) & 0xFF;
-        buf[2] = (val >> 16) & 0xFF;
-        buf[3] = (val >> 24) & 0xFF;
-        buf[4] = (val >> 32) & 0xFF;
-        buf[5] = (val >> 40) & 0xFF;
-        buf[6] = (val >> 48) & 0xFF;
-        buf[7] = (val >> 56) & 0xFF;
-    }
+    void OracleAnalyser::catchUpDropAll(void) {
+        if (catchUpWorkers != nullptr) {
+            for (uint64_t i = 0; i < catchUpThreads; ++i)
+                if (catchUpWorkers[i] != nullptr)
+                    catchUpWorkers[i]->stop();
+            {
+                unique_lock<mutex> lck(mtx);
+                analyserCond.notify_all();
+            }
 
-    void OracleAnalyser::write64Big(uint8_t* buf, uint64_t val) {
-        buf[0] = (val >> 56) & 0xFF;
-        buf[1] = (val >> 48) & 0xFF;
-        buf[2] = (val >> 40) & 0xFF;
-        buf[3] = (val >> 32) & 0xFF;
-        buf[4] = (val >> 24) & 0xFF;
-        buf[5] = (val >> 16) & 0xFF;
-        buf[6] = (val >> 8) & 0xFF;
-        buf[7] = val & 0xFF;
-    }
+            for (uint64_t i = 0; i < catchUpThreads; ++i) {
+                if (catchUpWorkers[i] == nullptr)
+                    continue;
+                if (catchUpWorkers[i]->started)
+                    pthread_join(catchUpWorkers[i]->pthread, nullptr);
+                delete catchUpWorkers[i];
+                catchUpWorkers[i] = nullptr;
+            }
+            delete[] catchUpWorkers;
+            catchUpWorkers = nullptr;
+        }
 
-    void OracleAnalyser::writeSCNLittle(uint8_t* buf, typescn val) {
-        if (val < 0x800000000000) {
-            buf[0] = val & 0xFF;
-            buf[1] = (val >> 8) & 0xFF;
-            buf[2] = (val >> 16) & 0xFF;
-            buf[3] = (val >> 24) & 0xFF;
-            buf[4] = (val >> 32) & 0xFF;
-            buf[5] = (val >> 40) & 0xFF;
-        } else {
-            buf[0] = val & 0xFF;
-            buf[1] = (val >> 8) & 0xFF;
-            buf[2] = (val >> 16) & 0xFF;
-            buf[3] = (val >> 24) & 0xFF;
-            buf[4] = (val >> 48) & 0xFF;
-            buf[5] = ((val >> 56) & 0xFF) | 0x80;
-            buf[6] = (val >> 32) & 0xFF;
-            buf[7] = (val >> 40) & 0xFF;
+        while (!catchUpRedoQueue.empty()) {
+            OracleAnalyserRedoLog *redoTmp = catchUpRedoQueue.front();
+            catchUpRedoQueue.pop();
+            delete redoTmp;
         }
     }
 
-    void OracleAnalyser::writeSCNBig(uint8_t* buf, typescn val) {
-        if (val < 0x800000000000) {
-            buf[5] = val & 0xFF;
-            buf[4] = (val >> 8) & 0xFF;
-            buf[3] = (val >> 16) & 0xFF;
-            buf[2] = (val >> 24) & 0xFF;
-            buf[1] = (val >> 32) & 0xFF;
-            buf[0] = (val >> 40) & 0xFF;
-        } else {
-            buf[5] = val & 0xFF;
-            buf[4] = (val >> 8) & 0xFF;
-            buf[3] = (val >> 16) & 0xFF;
-            buf[2] = (val >> 24) & 0xFF;
-            buf[1] = (val >> 48) & 0xFF;
-            buf[0] = ((val >> 56) & 0xFF) | 0x80;
-            buf[7] = (val >> 32) & 0xFF;
-            buf[6] = (val >> 40) & 0xFF;
+    void OracleAnalyser::updateOnlineLogs(void) {
+        for (OracleAnalyserRedoLog *oracleAnalyserRedoLog : onlineRedoSet) {
+            oracleAnalyserRedoLog->resetRedo();
+            if (!readerUpdateRedoLog(oracleAnalyserRedoLog->reader)) {
+                RUNTIME_FAIL("updating failed for " << dec << oracleAnalyserRedoLog->path);
+            } else {
+                notify.addWatch(oracleAnalyserRedoLog->reader->pathMapped, NOTIFY_MASK_FILE);
+                oracleAnalyserRedoLog->sequence = oracleAnalyserRedoLog->reader->sequence;
+                oracleAnalyserRedoLog->firstScn = oracleAnalyserRedoLog->reader->firstScn;
+                oracleAnalyserRedoLog->nextScn = oracleAnalyserRedoLog->reader->nextScn;
+            }
         }
     }
 
@@ -995,20 +928,6 @@ namespace OpenLogReplicator {
                         "HINT run: ALTER SYSTEM ARCHIVE LOG CURRENT;");
             }
 
-            if (isBigEndian) {
-                read16 = read16Big;
-                read32 = read32Big;
-                read56 = read56Big;
-                read64 = read64Big;
-                readSCN = readSCNBig;
-                readSCNr = readSCNrBig;
-                write16 = write16Big;
-                write32 = write32Big;
-                write56 = write56Big;
-                write64 = write64Big;
-                writeSCN = writeSCNBig;
-            }
-
             if (resetlogs != 0 && currentResetlogs != resetlogs) {
                 RUNTIME_FAIL("previous resetlogs:" << dec << resetlogs << ", expected: " << currentResetlogs);
             } else {
@@ -1125,6 +1044,7 @@ namespace OpenLogReplicator {
             checkOnlineRedoLogs();
         }
         archReader = readerCreate(0);
+        archReaderNext = readerCreate(0);
         readCheckpoint();
 
         INFO_("starting with:" <<
@@ -1161,19 +1081,6 @@ namespace OpenLogReplicator {
 
         const Value& bigEndianJSON = getJSONfield(fileName, document, "big-endian");
         isBigEndian = bigEndianJSON.GetUint64();
-        if (isBigEndian) {
-            read16 = read16Big;
-            read32 = read32Big;
-            read56 = read56Big;
-            read64 = read64Big;
-            readSCN = readSCNBig;
-            readSCNr = readSCNrBig;
-            write16 = write16Big;
-            write32 = write32Big;
-            write56 = write56Big;
-            write64 = write64Big;
-            writeSCN = writeSCNBig;
-        }
 
         const Value& resetlogsJSON = getJSONfield(fileName, document, "resetlogs");
         resetlogs = resetlogsJSON.GetUint64();
@@ -1229,6 +1136,7 @@ namespace OpenLogReplicator {
         if ((flags & REDO_FLAGS_ARCH_ONLY) == 0)
             checkOnlineRedoLogs();
         archReader = readerCreate(0);
+        archReaderNext = readerCreate(0);
 
         const Value& schema = getJSONfield(fileName, document, "schema");
         if (!schema.IsArray()) {
@@ -1401,8 +1309,8 @@ namespace OpenLogReplicator {
         ss << "]," << "\"schema\":[";
 
         hasPrev = false;
-        for (auto it : objectMap) {
-            OracleObject *objectTmp = it.second;
+        for (auto &entry : objectMap) {
+            OracleObject *objectTmp = entry.value;
 
             if (hasPrev)
                 ss << ",";
@@ -1479,9 +1387,14 @@ namespace OpenLogReplicator {
 
         uint64_t ret = REDO_OK;
         OracleAnalyserRedoLog *redo = nullptr;
+        //archived redo log already removed from the queue, owned until fully processed
+        OracleAnalyserRedoLog *redoArchived = nullptr;
         bool logsProcessed;
 
         try {
+            if (readerType == READER_BATCH)
+                renderDumps();
+
             while (!shutdown) {
                 logsProcessed = false;
 
@@ -1516,7 +1429,7 @@ namespace OpenLogReplicator {
 
                                 //all so far read, waiting for switch
                                 if (redo == nullptr && !isHigher) {
-                                    usleep(redoReadSleep);
+                                    notify.wait(redoReadSleep);
                                 } else
                                     break;
 
@@ -1534,7 +1447,12 @@ namespace OpenLogReplicator {
                         if (shutdown)
                             break;
                         logsProcessed = true;
+                        if (seekScn != ZERO_SCN) {
+                            redo->seek(seekScn);
+                            seekScn = ZERO_SCN;
+                        }
                         ret = redo->processLog();
+                        notify.reset();
 
                         if (shutdown)
                             break;
@@ -1551,7 +1469,7 @@ namespace OpenLogReplicator {
                             }
                         }
 
-                        if (rolledBack1 != nullptr)
+                        if (rollbackListOldest != nullptr)
                             freeRollbackList();
 
                         ++databaseSequence;
@@ -1570,7 +1488,7 @@ namespace OpenLogReplicator {
                 if (archiveRedoQueue.empty()) {
                     if ((flags & REDO_FLAGS_ARCH_ONLY) != 0) {
                         TRACE_(TRACE2_ARCHIVE_LIST, "archived redo log missing for sequence: " << dec << databaseSequence << ", sleeping");
-                        usleep(archReadSleep);
+                        notify.wait(archReadSleep);
                     } else {
                         RUNTIME_FAIL("could not find archive log for sequence: " << dec << databaseSequence);
                     }
@@ -1595,21 +1513,62 @@ namespace OpenLogReplicator {
                     }
 
                     logsProcessed = true;
-                    redo->reader = archReader;
 
-                    archReader->pathMapped = redo->path;
-                    if (!readerCheckRedoLog(archReader)) {
-                        RUNTIME_FAIL("opening archive log: " << redo->path);
+                    //decode following archived redo logs in parallel
+                    if (catchUpThreads > 1 && version != 0 && dumpRedoLog == 0 &&
+                            (ret != REDO_OVERWRITTEN || redoPrev == nullptr || redoPrev->sequence != redo->sequence)) {
+                        redo = nullptr;
+                        seekScn = ZERO_SCN;
+                        ret = archCatchUp();
+                        if (shutdown)
+                            break;
+                        continue;
+                    }
+
+                    bool prefetched = false;
+
+                    //the file has been already opened in background by the second reader
+                    if (redo == archRedoNext) {
+                        Reader *readerTmp = archReader;
+                        archReader = archReaderNext;
+                        archReaderNext = readerTmp;
+                        archRedoNext = nullptr;
+                        prefetched = readerPrefetchWait(archReader);
                     }
+                    redo->reader = archReader;
+
+                    if (!prefetched) {
+                        archReader->pathMapped = redo->path;
+                        if (!readerCheckRedoLog(archReader)) {
+                            RUNTIME_FAIL("opening archive log: " << redo->path);
+                        }
 
-                    if (!readerUpdateRedoLog(archReader)) {
-                        RUNTIME_FAIL("reading archive log: " << redo->path);
+                        if (!readerUpdateRedoLog(archReader)) {
+                            RUNTIME_FAIL("reading archive log: " << redo->path);
+                        }
                     }
 
                     if (ret == REDO_OVERWRITTEN && redoPrev != nullptr && redoPrev->sequence == redo->sequence) {
                         redo->continueRedo(redoPrev);
                     } else {
                         redo->resetRedo();
+                        if (seekScn != ZERO_SCN)
+                            redo->seek(seekScn);
+                    }
+                    seekScn = ZERO_SCN;
+
+                    //drop duplicates and start reading next file in background
+                    archiveRedoQueue.pop();
+                    redoArchived = redo;
+                    while (!archiveRedoQueue.empty() && archiveRedoQueue.top()->sequence == redo->sequence) {
+                        OracleAnalyserRedoLog *redoTmp = archiveRedoQueue.top();
+                        archiveRedoQueue.pop();
+                        delete redoTmp;
+                    }
+                    if (catchUpThreads <= 1 && !archiveRedoQueue.empty() && archiveRedoQueue.top()->sequence == redo->sequence + 1) {
+                        archRedoNext = archiveRedoQueue.top();
+                        archReaderNext->pathMapped = archRedoNext->path;
+                        readerPrefetchRedoLog(archReaderNext);
                     }
 
                     ret = redo->processLog();
@@ -1623,8 +1582,8 @@ namespace OpenLogReplicator {
 
                     ++databaseSequence;
                     writeCheckpoint(false);
-                    archiveRedoQueue.pop();
-                    delete redo;
+                    delete redoArchived;
+                    redoArchived = nullptr;
                     redo = nullptr;
                 }
 
@@ -1637,8 +1596,10 @@ namespace OpenLogReplicator {
                     break;
                 }
 
-                if (!logsProcessed)
-                    usleep(redoReadSleep);
+                if (logsProcessed)
+                    notify.reset();
+                else
+                    notify.wait(redoReadSleep);
             }
         } catch(ConfigurationException &ex) {
             stopMain();
@@ -1646,10 +1607,17 @@ namespace OpenLogReplicator {
             stopMain();
         }
 
+        //interrupted by shutdown or error while processing archived redo log
+        if (redoArchived != nullptr) {
+            delete redoArchived;
+            redoArchived = nullptr;
+        }
+
         INFO_("Oracle analyser for: " << database << " is shutting down");
 
         writeCheckpoint(true);
         FULL_(*this);
+        catchUpDropAll();
         readerDropAll();
 
         INFO_("Oracle analyser for: " << database << " is shut down, allocated at most " << dec <<
@@ -1660,92 +1628,141 @@ namespace OpenLogReplicator {
     }
 
     void OracleAnalyser::freeRollbackList(void) {
-        RedoLogRecord *tmpRedoLogRecord1, *tmpRedoLogRecord2;
         uint64_t lostElements = 0;
 
-        while (rolledBack1 != nullptr) {
-            WARNING_("element on rollback list UBA: " << PRINTUBA(rolledBack1->uba) <<
-                        " DBA: 0x" << hex << rolledBack2->dba <<
-                        " SLT: " << dec << (uint64_t)rolledBack2->slt <<
-                        " RCI: " << dec << (uint64_t)rolledBack2->rci <<
-                        " SCN: " << PRINTSCN64(rolledBack2->scnRecord) <<
-                        " OPFLAGS: " << hex << rolledBack2->opFlags);
-
-            tmpRedoLogRecord1 = rolledBack1;
-            tmpRedoLogRecord2 = rolledBack2;
-            rolledBack1 = rolledBack1->next;
-            rolledBack2 = rolledBack2->next;
-            delete tmpRedoLogRecord1;
-            delete tmpRedoLogRecord2;
+        while (rollbackListOldest != nullptr) {
+            RedoLogRecord *rollbackRedoLogRecord1 = &rollbackListOldest->redoLogRecord1;
+            RedoLogRecord *rollbackRedoLogRecord2 = &rollbackListOldest->redoLogRecord2;
+            WARNING_("element on rollback list UBA: " << PRINTUBA(rollbackRedoLogRecord1->uba) <<
+                        " DBA: 0x" << hex << rollbackRedoLogRecord2->dba <<
+                        " SLT: " << dec << (uint64_t)rollbackRedoLogRecord2->slt <<
+                        " RCI: " << dec << (uint64_t)rollbackRedoLogRecord2->rci <<
+                        " SCN: " << PRINTSCN64(rollbackRedoLogRecord2->scnRecord) <<
+                        " OPFLAGS: " << hex << rollbackRedoLogRecord2->opFlags);
+
+            rollbackListOldest = rollbackListOldest->next;
             ++lostElements;
         }
+        rollbackListNewest = nullptr;
+        rollbackListFree = nullptr;
+        rollbackListIndex.clear();
+
+        while (rollbackListChunks != nullptr) {
+            uint8_t *nextChunk = *((uint8_t**)rollbackListChunks);
+            freeMemoryChunk("ROLLBACK", rollbackListChunks, false);
+            rollbackListChunks = nextChunk;
+        }
     }
 
     bool OracleAnalyser::onRollbackList(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
-        RedoLogRecord *rollbackRedoLogRecord1, *rollbackRedoLogRecord2;
-
-        rollbackRedoLogRecord1 = rolledBack1;
-        rollbackRedoLogRecord2 = rolledBack2;
-        while (rollbackRedoLogRecord1 != nullptr) {
-            if (Transaction::matchesForRollback(redoLogRecord1, redoLogRecord2, rollbackRedoLogRecord1, rollbackRedoLogRecord2)) {
+        RollbackListEntry *entry = rollbackListIndex.get(ROLLBACK_KEY(redoLogRecord1->uba, redoLogRecord1->slt));
 
-                printRollbackInfo(rollbackRedoLogRecord1, rollbackRedoLogRecord2, nullptr, "rolled back from list");
-                if (rollbackRedoLogRecord1->next != nullptr) {
-                    rollbackRedoLogRecord1->next->prev = rollbackRedoLogRecord1->prev;
-                    rollbackRedoLogRecord2->next->prev = rollbackRedoLogRecord2->prev;
-                }
-
-                if (rollbackRedoLogRecord1->prev == nullptr) {
-                    rolledBack1 = rollbackRedoLogRecord1->next;
-                    rolledBack2 = rollbackRedoLogRecord2->next;
-                } else {
-                    rollbackRedoLogRecord1->prev->next = rollbackRedoLogRecord1->next;
-                    rollbackRedoLogRecord2->prev->next = rollbackRedoLogRecord2->next;
-                }
-
-                delete rollbackRedoLogRecord1;
-                delete rollbackRedoLogRecord2;
+        while (entry != nullptr) {
+            if (Transaction::matchesForRollback(redoLogRecord1, redoLogRecord2, &entry->redoLogRecord1, &entry->redoLogRecord2)) {
+                printRollbackInfo(&entry->redoLogRecord1, &entry->redoLogRecord2, nullptr, "rolled back from list");
+                removeFromRollbackList(entry);
                 return true;
             }
-
-            rollbackRedoLogRecord1 = rollbackRedoLogRecord1->next;
-            rollbackRedoLogRecord2 = rollbackRedoLogRecord2->next;
+            entry = entry->hashNext;
         }
         return false;
     }
 
     void OracleAnalyser::addToRollbackList(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
-        RedoLogRecord *tmpRedoLogRecord1 = new RedoLogRecord();
-        if (tmpRedoLogRecord1 == nullptr) {
-            RUNTIME_FAIL("could not allocate " << dec << sizeof(RedoLogRecord) << " bytes memory for (rollback list#1)");
+        if (rollbackListFree == nullptr) {
+            uint8_t *chunk = getMemoryChunk("ROLLBACK", false);
+            *((uint8_t**)chunk) = rollbackListChunks;
+            rollbackListChunks = chunk;
+
+            RollbackListEntry *entries = (RollbackListEntry*)(chunk + sizeof(uint8_t*));
+            for (uint64_t i = 0; i < ROLLBACK_LIST_IN_CHUNK; ++i) {
+                entries[i].next = rollbackListFree;
+                rollbackListFree = entries + i;
+            }
         }
 
-        RedoLogRecord *tmpRedoLogRecord2 = new RedoLogRecord();
-        if (tmpRedoLogRecord2 == nullptr) {
-            RUNTIME_FAIL("could not allocate " << dec << sizeof(RedoLogRecord) << " bytes memory for (rollback list#2)");
+        RollbackListEntry *entry = rollbackListFree;
+        rollbackListFree = entry->next;
+
+        memcpy(&entry->redoLogRecord1, redoLogRecord1, sizeof(RedoLogRecord));
+        memcpy(&entry->redoLogRecord2, redoLogRecord2, sizeof(RedoLogRecord));
+        //field offsets table belongs to the analysed record and is not copied
+        entry->redoLogRecord1.fieldOffsetsCnt = 0;
+        entry->redoLogRecord2.fieldOffsetsCnt = 0;
+
+        uint64_t key = ROLLBACK_KEY(redoLogRecord1->uba, redoLogRecord2->slt);
+        entry->hashNext = rollbackListIndex.get(key);
+        rollbackListIndex.set(key, entry);
+
+        entry->prev = rollbackListNewest;
+        entry->next = nullptr;
+        if (rollbackListNewest != nullptr)
+            rollbackListNewest->next = entry;
+        else
+            rollbackListOldest = entry;
+        rollbackListNewest = entry;
+    }
+
+    void OracleAnalyser::removeFromRollbackList(RollbackListEntry *entry) {
+        uint64_t key = ROLLBACK_KEY(entry->redoLogRecord1.uba, entry->redoLogRecord2.slt);
+        RollbackListEntry *entryTmp = rollbackListIndex.get(key);
+        if (entryTmp == entry) {
+            if (entry->hashNext != nullptr)
+                rollbackListIndex.set(key, entry->hashNext);
+            else
+                rollbackListIndex.erase(key);
+        } else {
+            while (entryTmp != nullptr && entryTmp->hashNext != entry)
+                entryTmp = entryTmp->hashNext;
+            if (entryTmp == nullptr) {
+                RUNTIME_FAIL("rollback list element missing in index, UBA: " << PRINTUBA(entry->redoLogRecord1.uba) <<
+                        ", SLT: " << dec << (uint64_t)entry->redoLogRecord2.slt);
+            }
+            entryTmp->hashNext = entry->hashNext;
         }
 
-        memcpy(tmpRedoLogRecord1, redoLogRecord1, sizeof(RedoLogRecord));
-        memcpy(tmpRedoLogRecord2, redoLogRecord2, sizeof(RedoLogRecord));
+        if (entry->prev != nullptr)
+            entry->prev->next = entry->next;
+        else
+            rollbackListOldest = entry->next;
+        if (entry->next != nullptr)
+            entry->next->prev = entry->prev;
+        else
+            rollbackListNewest = entry->prev;
 
-        tmpRedoLogRecord1->next = rolledBack1;
-        tmpRedoLogRecord2->next = rolledBack2;
+        entry->next = rollbackListFree;
+        rollbackListFree = entry;
+    }
 
-        if (rolledBack1 != nullptr) {
-            rolledBack1->prev = tmpRedoLogRecord1;
-            rolledBack2->prev = tmpRedoLogRecord2;
+    //unmatched element can only be matched by operation of a transaction which is still open
+    void OracleAnalyser::expireRollbackList(typescn checkpointScn) {
+        if (rollbackListOldest == nullptr || rollbackListOldest->redoLogRecord2.scn >= checkpointScn)
+            return;
+
+        typescn minScn = checkpointScn;
+        for (uint64_t i = 1; i <= transactionHeap->size; ++i) {
+            Transaction *transaction = transactionHeap->at(i);
+            //only split blocks so far, their SCN is not known here
+            if (transaction->firstScn == ZERO_SCN)
+                return;
+            if (transaction->firstScn < minScn)
+                minScn = transaction->firstScn;
+        }
+
+        while (rollbackListOldest != nullptr && rollbackListOldest->redoLogRecord2.scn < minScn) {
+            printRollbackInfo(&rollbackListOldest->redoLogRecord1, &rollbackListOldest->redoLogRecord2, nullptr, "expired from list");
+            removeFromRollbackList(rollbackListOldest);
         }
-        rolledBack1 = tmpRedoLogRecord1;
-        rolledBack2 = tmpRedoLogRecord2;
     }
 
     OracleObject *OracleAnalyser::checkDict(typeobj objn, typeobj objd) {
-        OracleObject *objectTmp = partitionMap[objn];
-        return objectTmp;
+        //called from catch-up workers too, must not modify the map
+        return partitionMap.get(objn);
     }
 
     bool OracleAnalyser::readerCheckRedoLog(Reader *reader) {
         unique_lock<mutex> lck(mtx);
+        reader->prefetch = false;
         reader->status = READER_STATUS_CHECK;
         reader->sequence = 0;
         reader->firstScn = ZERO_SCN;
@@ -1765,6 +1782,34 @@ namespace OpenLogReplicator {
             return false;
     }
 
+    void OracleAnalyser::readerPrefetchRedoLog(Reader *reader) {
+        unique_lock<mutex> lck(mtx);
+        reader->prefetch = true;
+        reader->status = READER_STATUS_CHECK;
+        reader->sequence = 0;
+        reader->firstScn = ZERO_SCN;
+        reader->nextScn = ZERO_SCN;
+
+        readerCond.notify_all();
+        sleepingCond.notify_all();
+    }
+
+    bool OracleAnalyser::readerPrefetchWait(Reader *reader) {
+        unique_lock<mutex> lck(mtx);
+        while (reader->status == READER_STATUS_CHECK || reader->status == READER_STATUS_UPDATE) {
+            if (shutdown)
+                break;
+            analyserCond.wait(lck);
+        }
+        reader->prefetch = false;
+
+        //in case of any error the file is opened once again
+        if (reader->ret == REDO_OK || reader->ret == REDO_FINISHED)
+            return true;
+        else
+            return false;
+    }
+
     void OracleAnalyser::readerDropAll(void) {
         {
             unique_lock<mutex> lck(mtx);
@@ -1779,6 +1824,8 @@ namespace OpenLogReplicator {
             delete reader;
         }
         archReader = nullptr;
+        archReaderNext = nullptr;
+        archRedoNext = nullptr;
         readers.clear();
     }
 
@@ -1810,6 +1857,12 @@ namespace OpenLogReplicator {
 
         if (readerType == READER_ASM) {
             reader = new ReaderASM(alias.c_str(), this, group);
+        } else if ((flags & REDO_FLAGS_ARCH_MMAP) != 0 && group == 0) {
+            reader = new ReaderMmap(alias.c_str(), this, group);
+        } else if (readQueueDepth > 1 && group == 0) {
+            reader = new ReaderFilesystemUring(alias.c_str(), this, group, readQueueDepth);
+        } else if (group == 0) {
+            reader = new ReaderCompressed(alias.c_str(), this, group);
         } else {
             reader = new ReaderFilesystem(alias.c_str(), this, group);
         }
@@ -1817,8 +1870,12 @@ namespace OpenLogReplicator {
         if (reader == nullptr) {
             RUNTIME_FAIL("could not allocate " << dec << sizeof(ReaderFilesystem) << " bytes memory for (disk reader creation)");
         }
-
         readers.insert(reader);
+
+        //memory mapped archived redo logs are not copied to the buffer
+        if (group == 0 && (readerType == READER_ASM || (flags & REDO_FLAGS_ARCH_MMAP) == 0))
+            reader->bufferAllocate(readBufferMb);
+
         if (pthread_create(&reader->pthread, nullptr, &Reader::runStatic, (void*)reader)) {
             CONFIG_FAIL("spawning thread");
         }
@@ -1860,7 +1917,7 @@ namespace OpenLogReplicator {
     }
 
     //checking if file name looks something like o1_mf_1_SSSS_XXXXXXXX_.arc
-    //SS - sequence number
+    //SS - sequence number, archived redo log may be also compressed: .arc.gz or .arc.zst
     uint64_t OracleAnalyser::getSequenceFromFileName(const char *file) {
         uint64_t sequence = 0, i, j, iMax = strnlen(file, 256);
         for (i = 0; i < iMax; ++i)
@@ -1904,8 +1961,8 @@ namespace OpenLogReplicator {
         if (i >= iMax || file[i] != '_')
             return 0;
 
-        //fifth '_'
-        if (strncmp(file + i, "_.arc", 5) != 0)
+        //fifth '_', skip files which are still being copied or compressed
+        if (strcmp(file + i, "_.arc") != 0 && strcmp(file + i, "_.arc.gz") != 0 && strcmp(file + i, "_.arc.zst") != 0)
             return 0;
 
         return sequence;
@@ -2175,6 +2232,9 @@ namespace OpenLogReplicator {
             readerCond.notify_all();
             sleepingCond.notify_all();
             analyserCond.notify_all();
+        }
+        {
+            unique_lock<mutex> lck(memoryMtx);
             memoryCond.notify_all();
         }
     }
@@ -2186,6 +2246,19 @@ namespace OpenLogReplicator {
         pathMapping.push_back(targetMapping);
     }
 
+    void OracleAnalyser::buildFieldOffsets(RedoLogRecord *redoLogRecord, uint16_t *fieldOffsets, uint64_t fieldOffsetsMax) {
+        uint64_t fieldPos = redoLogRecord->fieldPos;
+        redoLogRecord->fieldOffsets = fieldOffsets;
+        redoLogRecord->fieldOffsetsCnt = 0;
+
+        //field positions are aligned to 4 bytes
+        for (uint64_t i = 1; i <= redoLogRecord->fieldCnt && i <= fieldOffsetsMax && fieldPos <= FIELD_OFFSET_MAX; ++i) {
+            fieldOffsets[i - 1] = fieldPos >> 2;
+            redoLogRecord->fieldOffsetsCnt = i;
+            fieldPos += (read16(redoLogRecord->data + redoLogRecord->fieldLengthsDelta + i * 2) + 3) & 0xFFFC;
+        }
+    }
+
     void OracleAnalyser::skipEmptyFields(RedoLogRecord *redoLogRecord, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength) {
         uint16_t nextFieldLength;
         while (fieldNum + 1 <= redoLogRecord->fieldCnt) {
@@ -2194,7 +2267,9 @@ namespace OpenLogReplicator {
                 return;
             ++fieldNum;
 
-            if (fieldNum == 1)
+            if (fieldNum <= redoLogRecord->fieldOffsetsCnt)
+                fieldPos = ((uint64_t)redoLogRecord->fieldOffsets[fieldNum - 1]) << 2;
+            else if (fieldNum == 1)
                 fieldPos = redoLogRecord->fieldPos;
             else
                 fieldPos += (fieldLength + 3) & 0xFFFC;
@@ -2211,6 +2286,29 @@ namespace OpenLogReplicator {
         redoLogsBatch.push_back(path);
     }
 
+    void OracleAnalyser::renderDumps(void) {
+        uint64_t dumpRedoLogOld = dumpRedoLog;
+        if (dumpRedoLog == 0)
+            dumpRedoLog = 1;
+
+        for (string &path : redoLogsBatch) {
+            if (path.length() <= 12 || path.compare(path.length() - 12, 12, ".logdump.bin") != 0)
+                continue;
+
+            OracleAnalyserRedoLog* redo = new OracleAnalyserRedoLog(this, 0, path.c_str());
+            if (redo == nullptr) {
+                RUNTIME_FAIL("could not allocate " << dec << sizeof(OracleAnalyserRedoLog) << " bytes memory for (render dump)");
+            }
+            redo->renderDump();
+            delete redo;
+
+            if (shutdown)
+                break;
+        }
+
+        dumpRedoLog = dumpRedoLogOld;
+    }
+
     void OracleAnalyser::nextField(RedoLogRecord *redoLogRecord, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength) {
         ++fieldNum;
         if (fieldNum > redoLogRecord->fieldCnt) {
@@ -2223,7 +2321,9 @@ namespace OpenLogReplicator {
                     ", suppCC: " << dec << redoLogRecord->suppLogCC);
         }
 
-        if (fieldNum == 1)
+        if (fieldNum <= redoLogRecord->fieldOffsetsCnt)
+            fieldPos = ((uint64_t)redoLogRecord->fieldOffsets[fieldNum - 1]) << 2;
+        else if (fieldNum == 1)
             fieldPos = redoLogRecord->fieldPos;
         else
             fieldPos += (fieldLength + 3) & 0xFFFC;
@@ -2241,7 +2341,9 @@ namespace OpenLogReplicator {
 
         ++fieldNum;
 
-        if (fieldNum == 1)
+        if (fieldNum <= redoLogRecord->fieldOffsetsCnt)
+            fieldPos = ((uint64_t)redoLogRecord->fieldOffsets[fieldNum - 1]) << 2;
+        else if (fieldNum == 1)
             fieldPos = redoLogRecord->fieldPos;
         else
             fieldPos += (fieldLength + 3) & 0xFFFC;
@@ -2254,6 +2356,21 @@ namespace OpenLogReplicator {
         return true;
     }
 
+    void OracleAnalyser::skipToField(RedoLogRecord *redoLogRecord, uint64_t targetNum, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength) {
+        if (fieldNum >= targetNum)
+            return;
+
+        //position known from field offsets table, no need to walk field lengths
+        if (targetNum <= redoLogRecord->fieldOffsetsCnt) {
+            fieldNum = targetNum - 1;
+            nextField(redoLogRecord, fieldNum, fieldPos, fieldLength);
+            return;
+        }
+
+        while (fieldNum < targetNum)
+            nextField(redoLogRecord, fieldNum, fieldPos, fieldLength);
+    }
+
     string OracleAnalyser::applyMapping(string path) {
         uint64_t sourceLength, targetLength, newPathLength = path.length();
         char pathBuffer[MAX_PATH_LENGTH];
@@ -2306,15 +2423,15 @@ namespace OpenLogReplicator {
         TRACE_(TRACE2_MEMORY, module << " - get at: " << dec << memoryChunksFree << "/" << memoryChunksAllocated);
 
         {
-            unique_lock<mutex> lck(mtx);
+            unique_lock<mutex> lck(memoryMtx);
 
             if (memoryChunksFree == 0) {
-                if (memoryChunksAllocated == memoryChunksMax) {
+                if (memoryChunksAllocated + memoryChunksReserved >= memoryChunksMax) {
                     if (memoryChunksSupplemental > 0 && waitingForWriter) {
                         WARNING_("out of memory, sleeping until writer buffers are free and release some");
                         memoryCond.wait(lck);
                     }
-                    if (memoryChunksAllocated == memoryChunksMax) {
+                    if (memoryChunksAllocated + memoryChunksReserved >= memoryChunksMax) {
                         RUNTIME_FAIL("used all memory up to memory-max-mb parameter, restart with higher value, module: " << module);
                     }
                 }
@@ -2326,8 +2443,8 @@ namespace OpenLogReplicator {
                 ++memoryChunksFree;
                 ++memoryChunksAllocated;
 
-                if (memoryChunksAllocated > memoryChunksHWM)
-                    memoryChunksHWM = memoryChunksAllocated;
+                if (memoryChunksAllocated + memoryChunksReserved > memoryChunksHWM)
+                    memoryChunksHWM = memoryChunksAllocated + memoryChunksReserved;
             }
 
             --memoryChunksFree;
@@ -2337,11 +2454,15 @@ namespace OpenLogReplicator {
         }
     }
 
+    string OracleAnalyser::getIndexFileName(typeseq sequence) {
+        return databaseContext + "-" + to_string(sequence) + ".logidx";
+    }
+
     void OracleAnalyser::freeMemoryChunk(const char *module, uint8_t *chunk, bool supp) {
         TRACE_(TRACE2_MEMORY, module << " - free at: " << dec << memoryChunksFree << "/" << memoryChunksAllocated);
 
         {
-            unique_lock<mutex> lck(mtx);
+            unique_lock<mutex> lck(memoryMtx);
 
             if (memoryChunksFree == memoryChunksAllocated) {
                 RUNTIME_FAIL("trying to free unknown memory block for module: " << module);
@@ -2360,6 +2481,59 @@ namespace OpenLogReplicator {
         }
     }
 
+    //used memory above 75% of memory-max-mb
+    bool OracleAnalyser::memoryLow(void) {
+        unique_lock<mutex> lck(memoryMtx);
+        return (memoryChunksAllocated - memoryChunksFree + memoryChunksReserved) * 4 >= memoryChunksMax * 3;
+    }
+
+    //memory allocated outside of memory chunks, counted against memory-max-mb in whole chunks
+    void OracleAnalyser::reserveMemoryChunks(const char *module, uint64_t chunks) {
+        TRACE_(TRACE2_MEMORY, module << " - reserve: " << dec << chunks << " at: " << memoryChunksReserved << "/" << memoryChunksAllocated);
+
+        {
+            unique_lock<mutex> lck(memoryMtx);
+
+            //release cached free chunks first to make room
+            while (memoryChunksAllocated + memoryChunksReserved + chunks > memoryChunksMax && memoryChunksFree > 0) {
+                --memoryChunksFree;
+                delete[] memoryChunks[memoryChunksFree];
+                memoryChunks[memoryChunksFree] = nullptr;
+                --memoryChunksAllocated;
+            }
+
+            if (memoryChunksAllocated + memoryChunksReserved + chunks > memoryChunksMax) {
+                RUNTIME_FAIL("used all memory up to memory-max-mb parameter, restart with higher value, module: " << module);
+            }
+
+            memoryChunksReserved += chunks;
+            if (memoryChunksAllocated + memoryChunksReserved > memoryChunksHWM)
+                memoryChunksHWM = memoryChunksAllocated + memoryChunksReserved;
+        }
+    }
+
+    void OracleAnalyser::releaseMemoryChunks(const char *module, uint64_t chunks) {
+        TRACE_(TRACE2_MEMORY, module << " - release: " << dec << chunks << " at: " << memoryChunksReserved << "/" << memoryChunksAllocated);
+
+        {
+            unique_lock<mutex> lck(memoryMtx);
+
+            if (chunks > memoryChunksReserved) {
+                RUNTIME_FAIL("trying to release more memory than reserved for module: " << module);
+            }
+            memoryChunksReserved -= chunks;
+        }
+    }
+
+    void OracleAnalyser::updateRollbackIndexMemory(void) {
+        uint64_t indexChunks = (rollbackIndex.memorySize() + rollbackKeysCnt * sizeof(uint64_t) + MEMORY_CHUNK_SIZE - 1) / MEMORY_CHUNK_SIZE;
+        if (indexChunks > rollbackIndexChunks)
+            reserveMemoryChunks("rollback index", indexChunks - rollbackIndexChunks);
+        else if (indexChunks < rollbackIndexChunks)
+            releaseMemoryChunks("rollback index", rollbackIndexChunks - indexChunks);
+        rollbackIndexChunks = indexChunks;
+    }
+
     bool OracleAnalyserRedoLogCompare::operator()(OracleAnalyserRedoLog* const& p1, OracleAnalyserRedoLog* const& p2) {
         return p1->sequence > p2->sequence;
     }
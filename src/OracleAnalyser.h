@@ -30,6 +30,9 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <stdint.h>
 
 #include "types.h"
+#include "FileNotify.h"
+#include "HashMap.h"
+#include "RedoLogRecord.h"
 #include "Thread.h"
 #include "TransactionBuffer.h"
 #include "TransactionHeap.h"
@@ -38,6 +41,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef ORACLEANALYSER_H_
 #define ORACLEANALYSER_H_
 
+#define ROLLBACK_LIST_IN_CHUNK ((MEMORY_CHUNK_SIZE-sizeof(uint8_t*))/sizeof(RollbackListEntry))
+
 using namespace std;
 
 namespace OpenLogReplicator {
@@ -46,6 +51,7 @@ namespace OpenLogReplicator {
     class DatabaseEnvironment;
     class OracleObject;
     class OracleAnalyserRedoLog;
+    class OracleAnalyserWorker;
     class OutputBuffer;
     class Reader;
     class RedoLogRecord;
@@ -59,6 +65,14 @@ namespace OpenLogReplicator {
         bool operator()(OracleAnalyserRedoLog* const& p1, OracleAnalyserRedoLog* const& p2);
     };
 
+    struct RollbackListEntry {
+        RedoLogRecord redoLogRecord1;
+        RedoLogRecord redoLogRecord2;
+        RollbackListEntry *hashNext;        //same uba and slot
+        RollbackListEntry *prev;            //order of adding, used for expiry
+        RollbackListEntry *next;
+    };
+
     class OracleAnalyser : public Thread {
     protected:
         static const char* SQL_GET_ARCHIVE_LOG_LIST;
@@ -89,14 +103,22 @@ namespace OpenLogReplicator {
         string logArchiveFormat;
         string logArchiveDest;
         Reader *archReader;
-        RedoLogRecord *rolledBack1;
-        RedoLogRecord *rolledBack2;
+        Reader *archReaderNext;
+        OracleAnalyserRedoLog *archRedoNext;
+        OracleAnalyserWorker **catchUpWorkers;
+        //unmatched rollback vectors, entries are taken from memory chunks
+        RollbackListEntry *rollbackListOldest;
+        RollbackListEntry *rollbackListNewest;
+        RollbackListEntry *rollbackListFree;
+        uint8_t *rollbackListChunks;
+        HashMap<uint64_t, RollbackListEntry*> rollbackListIndex;
 
         priority_queue<OracleAnalyserRedoLog*, vector<OracleAnalyserRedoLog*>, OracleAnalyserRedoLogCompare> archiveRedoQueue;
+        queue<OracleAnalyserRedoLog*> catchUpRedoQueue;
         set<OracleAnalyserRedoLog*> onlineRedoSet;
         set<Reader*> readers;
-        unordered_map<typeobj, OracleObject*> objectMap;
-        unordered_map<typeobj, OracleObject*> partitionMap;
+        HashMap<typeobj, OracleObject*> objectMap;
+        HashMap<typeobj, OracleObject*> partitionMap;
         uint64_t suppLogDbPrimary, suppLogDbAll;
         clock_t previousCheckpoint;
         uint64_t checkpointInterval;
@@ -109,7 +131,11 @@ namespace OpenLogReplicator {
         uint64_t memoryChunksMax;
         uint64_t memoryChunksHWM;
         uint64_t memoryChunksSupplemental;
+        uint64_t memoryChunksReserved;
+        typescn seekScn;
+        typeseq indexSequence;
         OracleObject *object;
+        FileNotify notify;
 
         stringstream& writeEscapeValue(stringstream &ss, string &str);
         string getParameterValue(const char *parameter);
@@ -121,7 +147,10 @@ namespace OpenLogReplicator {
         void closeConnection(void);
         void archLogGetList(void);
         void updateOnlineLogs(void);
-        bool readerCheckRedoLog(Reader *reader);
+        uint64_t archCatchUp(void);
+        void catchUpDropAll(void);
+        void readerPrefetchRedoLog(Reader *reader);
+        bool readerPrefetchWait(Reader *reader);
         void readerDropAll(void);
         void checkTableForGrants(string tableName);
         Reader *readerCreate(int64_t group);
@@ -132,7 +161,8 @@ namespace OpenLogReplicator {
         OracleAnalyser(OutputBuffer *outputBuffer, const char *alias, const char *database, const char *user, const char *password,
                 const char *connectString, const char *userASM, const char *passwdASM, const char *connectStringASM, uint64_t arch, uint64_t trace,
                 uint64_t trace2, uint64_t dumpRedoLog, uint64_t dumpData, uint64_t flags, uint64_t readerType, uint64_t disableChecks,
-                uint64_t redoReadSleep, uint64_t archReadSleep, uint64_t checkpointInterval, uint64_t memoryMinMb, uint64_t memoryMaxMb);
+                uint64_t redoReadSleep, uint64_t archReadSleep, uint64_t checkpointInterval, uint64_t memoryMinMb, uint64_t memoryMaxMb,
+                uint64_t readQueueDepth, uint64_t catchUpThreads, uint64_t readBufferMb, uint64_t transactionSpillMb);
         virtual ~OracleAnalyser();
 
         DatabaseEnvironment *env;
@@ -140,13 +170,17 @@ namespace OpenLogReplicator {
         DatabaseConnection *connASM;
         bool waitingForWriter;
         mutex mtx;
+        mutex memoryMtx;
         condition_variable readerCond;
         condition_variable sleepingCond;
         condition_variable analyserCond;
         condition_variable memoryCond;
         string databaseContext;
         typescn databaseScn;
-        unordered_map<typexid, Transaction*> xidTransactionMap;
+        HashMap<typexid, Transaction*> xidTransactionMap;
+        HashMap<uint64_t, RollbackIndexEntry> rollbackIndex;
+        uint64_t rollbackKeysCnt;
+        uint64_t rollbackIndexChunks;
         TransactionMap *lastOpTransactionMap;
         TransactionHeap *transactionHeap;
         TransactionBuffer *transactionBuffer;
@@ -162,6 +196,10 @@ namespace OpenLogReplicator {
         vector<string> redoLogsBatch;
         uint64_t redoReadSleep;
         uint64_t archReadSleep;
+        uint64_t readQueueDepth;
+        uint64_t catchUpThreads;
+        uint64_t readBufferMb;
+        uint64_t transactionSpillMb;
         uint64_t arch;
         uint64_t trace;
         uint64_t trace2;
@@ -172,19 +210,18 @@ namespace OpenLogReplicator {
         typeresetlogs resetlogs;
         typeactivation activation;
         uint64_t isBigEndian;
-        uint64_t suppLogSize;
-
-        uint16_t (*read16)(const uint8_t* buf);
-        uint32_t (*read32)(const uint8_t* buf);
-        uint64_t (*read56)(const uint8_t* buf);
-        uint64_t (*read64)(const uint8_t* buf);
-        typescn (*readSCN)(const uint8_t* buf);
-        typescn (*readSCNr)(const uint8_t* buf);
-        void (*write16)(uint8_t* buf, uint16_t val);
-        void (*write32)(uint8_t* buf, uint32_t val);
-        void (*write56)(uint8_t* buf, uint64_t val);
-        void (*write64)(uint8_t* buf, uint64_t val);
-        void (*writeSCN)(uint8_t* buf, typescn val);
+
+        uint16_t read16(const uint8_t* buf) const;
+        uint32_t read32(const uint8_t* buf) const;
+        uint64_t read56(const uint8_t* buf) const;
+        uint64_t read64(const uint8_t* buf) const;
+        typescn readSCN(const uint8_t* buf) const;
+        typescn readSCNr(const uint8_t* buf) const;
+        void write16(uint8_t* buf, uint16_t val) const;
+        void write32(uint8_t* buf, uint32_t val) const;
+        void write56(uint8_t* buf, uint64_t val) const;
+        void write64(uint8_t* buf, uint64_t val) const;
+        void writeSCN(uint8_t* buf, typescn val) const;
 
         static uint16_t read16Little(const uint8_t* buf);
         static uint16_t read16Big(const uint8_t* buf);
@@ -217,26 +254,305 @@ namespace OpenLogReplicator {
         void freeRollbackList(void);
         bool onRollbackList(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
         void addToRollbackList(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
+        void removeFromRollbackList(RollbackListEntry *entry);
+        void expireRollbackList(typescn checkpointScn);
         OracleObject *checkDict(typeobj objn, typeobj objd);
         void addTable(const char *mask, vector<string> &keys, string &keysStr, uint64_t options);
         void checkForCheckpoint(void);
+        bool readerCheckRedoLog(Reader *reader);
         bool readerUpdateRedoLog(Reader *reader);
         virtual void stop(void);
         void addPathMapping(const char* source, const char* target);
         void addRedoLogsBatch(string path);
+        void renderDumps(void);
 
+        void buildFieldOffsets(RedoLogRecord *redoLogRecord, uint16_t *fieldOffsets, uint64_t fieldOffsetsMax);
         void skipEmptyFields(RedoLogRecord *redoLogRecord, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength);
         void nextField(RedoLogRecord *redoLogRecord, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength);
         bool nextFieldOpt(RedoLogRecord *redoLogRecord, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength);
+        void skipToField(RedoLogRecord *redoLogRecord, uint64_t targetNum, uint64_t &fieldNum, uint64_t &fieldPos, uint16_t &fieldLength);
         string applyMapping(string path);
         void printRollbackInfo(RedoLogRecord *redoLogRecord, Transaction *transaction, const char *msg);
         void printRollbackInfo(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2, Transaction *transaction, const char *msg);
 
         uint8_t *getMemoryChunk(const char *module, bool supp);
+        string getIndexFileName(typeseq sequence);
         void freeMemoryChunk(const char *module, uint8_t *chunk, bool supp);
+        bool memoryLow(void);
+        void reserveMemoryChunks(const char *module, uint64_t chunks);
+        void releaseMemoryChunks(const char *module, uint64_t chunks);
+        void updateRollbackIndexMemory(void);
 
         friend ostream& operator<<(ostream& os, const OracleAnalyser& oracleAnalyser);
     };
+
+    //byte order decoding is called for every field of every vector, defined here to be inlined
+    inline uint16_t OracleAnalyser::read16Little(const uint8_t* buf) {
+        return (uint16_t)buf[0] | ((uint16_t)buf[1] << 8);
+    }
+
+    inline uint16_t OracleAnalyser::read16Big(const uint8_t* buf) {
+        return ((uint16_t)buf[0] << 8) | (uint16_t)buf[1];
+    }
+
+    inline uint32_t OracleAnalyser::read32Little(const uint8_t* buf) {
+        return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+                ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    }
+
+    inline uint32_t OracleAnalyser::read32Big(const uint8_t* buf) {
+        return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+                ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+    }
+
+    inline uint64_t OracleAnalyser::read56Little(const uint8_t* buf) {
+        return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
+                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
+                ((uint64_t)buf[4] << 32) | ((uint64_t)buf[5] << 40) |
+                ((uint64_t)buf[6] << 48);
+    }
+
+    inline uint64_t OracleAnalyser::read56Big(const uint8_t* buf) {
+        return (((uint64_t)buf[0] << 24) | ((uint64_t)buf[1] << 16) |
+                ((uint64_t)buf[2] << 8) | ((uint64_t)buf[3]) |
+                ((uint64_t)buf[4] << 40) | ((uint64_t)buf[5] << 32) |
+                ((uint64_t)buf[6] << 48));
+    }
+
+    inline uint64_t OracleAnalyser::read64Little(const uint8_t* buf) {
+        return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
+                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
+                ((uint64_t)buf[4] << 32) | ((uint64_t)buf[5] << 40) |
+                ((uint64_t)buf[6] << 48) | ((uint64_t)buf[7] << 56);
+    }
+
+    inline uint64_t OracleAnalyser::read64Big(const uint8_t* buf) {
+        return ((uint64_t)buf[0] << 56) | ((uint64_t)buf[1] << 48) |
+                ((uint64_t)buf[2] << 40) | ((uint64_t)buf[3] << 32) |
+                ((uint64_t)buf[4] << 24) | ((uint64_t)buf[5] << 16) |
+                ((uint64_t)buf[6] << 8) | (uint64_t)buf[7];
+    }
+
+    inline typescn OracleAnalyser::readSCNLittle(const uint8_t* buf) {
+        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
+            return ZERO_SCN;
+        if ((buf[5] & 0x80) == 0x80)
+            return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
+                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
+                ((uint64_t)buf[6] << 32) | ((uint64_t)buf[7] << 40) |
+                ((uint64_t)buf[4] << 48) | ((uint64_t)(buf[5] & 0x7F) << 56);
+        else
+            return (uint64_t)buf[0] | ((uint64_t)buf[1] << 8) |
+                ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 24) |
+                ((uint64_t)buf[4] << 32) | ((uint64_t)buf[5] << 40);
+    }
+
+    inline typescn OracleAnalyser::readSCNBig(const uint8_t* buf) {
+        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
+            return ZERO_SCN;
+        if ((buf[4] & 0x80) == 0x80)
+            return (uint64_t)buf[3] | ((uint64_t)buf[2] << 8) |
+                ((uint64_t)buf[1] << 16) | ((uint64_t)buf[0] << 24) |
+                ((uint64_t)buf[7] << 32) | ((uint64_t)buf[6] << 40) |
+                ((uint64_t)buf[5] << 48) | ((uint64_t)(buf[4] & 0x7F) << 56);
+        else
+            return (uint64_t)buf[3] | ((uint64_t)buf[2] << 8) |
+                ((uint64_t)buf[1] << 16) | ((uint64_t)buf[0] << 24) |
+                ((uint64_t)buf[5] << 32) | ((uint64_t)buf[4] << 40);
+    }
+
+    inline typescn OracleAnalyser::readSCNrLittle(const uint8_t* buf) {
+        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
+            return ZERO_SCN;
+        if ((buf[1] & 0x80) == 0x80)
+            return (uint64_t)buf[2] | ((uint64_t)buf[3] << 8) |
+                ((uint64_t)buf[4] << 16) | ((uint64_t)buf[5] << 24) |
+                //((uint64_t)buf[6] << 32) | ((uint64_t)buf[7] << 40) |
+                ((uint64_t)buf[0] << 48) | ((uint64_t)(buf[1] & 0x7F) << 56);
+        else
+            return (uint64_t)buf[2] | ((uint64_t)buf[3] << 8) |
+                ((uint64_t)buf[4] << 16) | ((uint64_t)buf[5] << 24) |
+                ((uint64_t)buf[0] << 32) | ((uint64_t)buf[1] << 40);
+    }
+
+    inline typescn OracleAnalyser::readSCNrBig(const uint8_t* buf) {
+        if (buf[0] == 0xFF && buf[1] == 0xFF && buf[2] == 0xFF && buf[3] == 0xFF && buf[4] == 0xFF && buf[5] == 0xFF)
+            return ZERO_SCN;
+        if ((buf[0] & 0x80) == 0x80)
+            return (uint64_t)buf[5] | ((uint64_t)buf[4] << 8) |
+                ((uint64_t)buf[3] << 16) | ((uint64_t)buf[2] << 24) |
+                //((uint64_t)buf[7] << 32) | ((uint64_t)buf[6] << 40) |
+                ((uint64_t)buf[1] << 48) | ((uint64_t)(buf[0] & 0x7F) << 56);
+        else
+            return (uint64_t)buf[5] | ((uint64_t)buf[4] << 8) |
+                ((uint64_t)buf[3] << 16) | ((uint64_t)buf[2] << 24) |
+                ((uint64_t)buf[1] << 32) | ((uint64_t)buf[0] << 40);
+    }
+
+    inline void OracleAnalyser::write16Little(uint8_t* buf, uint16_t val) {
+        buf[0] = val & 0xFF;
+        buf[1] = (val >> 8) & 0xFF;
+    }
+
+    inline void OracleAnalyser::write16Big(uint8_t* buf, uint16_t val) {
+        buf[0] = (val >> 8) & 0xFF;
+        buf[1] = val & 0xFF;
+    }
+
+    inline void OracleAnalyser::write32Little(uint8_t* buf, uint32_t val) {
+        buf[0] = val & 0xFF;
+        buf[1] = (val >> 8) & 0xFF;
+        buf[2] = (val >> 16) & 0xFF;
+        buf[3] = (val >> 24) & 0xFF;
+    }
+
+    inline void OracleAnalyser::write32Big(uint8_t* buf, uint32_t val) {
+        buf[0] = (val >> 24) & 0xFF;
+        buf[1] = (val >> 16) & 0xFF;
+        buf[2] = (val >> 8) & 0xFF;
+        buf[3] = val & 0xFF;
+    }
+
+    inline void OracleAnalyser::write56Little(uint8_t* buf, uint64_t val) {
+        buf[0] = val & 0xFF;
+        buf[1] = (val >> 8) & 0xFF;
+        buf[2] = (val >> 16) & 0xFF;
+        buf[3] = (val >> 24) & 0xFF;
+        buf[4] = (val >> 32) & 0xFF;
+        buf[5] = (val >> 40) & 0xFF;
+        buf[6] = (val >> 48) & 0xFF;
+    }
+
+    inline void OracleAnalyser::write56Big(uint8_t* buf, uint64_t val) {
+        buf[0] = (val >> 48) & 0xFF;
+        buf[1] = (val >> 40) & 0xFF;
+        buf[2] = (val >> 32) & 0xFF;
+        buf[3] = (val >> 24) & 0xFF;
+        buf[4] = (val >> 16) & 0xFF;
+        buf[5] = (val >> 8) & 0xFF;
+        buf[6] = val & 0xFF;
+    }
+
+    inline void OracleAnalyser::write64Little(uint8_t* buf, uint64_t val) {
+        buf[0] = val & 0xFF;
+        buf[1] = (val >> 8) & 0xFF;
+        buf[2] = (val >> 16) & 0xFF;
+        buf[3] = (val >> 24) & 0xFF;
+        buf[4] = (val >> 32) & 0xFF;
+        buf[5] = (val >> 40) & 0xFF;
+        buf[6] = (val >> 48) & 0xFF;
+        buf[7] = (val >> 56) & 0xFF;
+    }
+
+    inline void OracleAnalyser::write64Big(uint8_t* buf, uint64_t val) {
+        buf[0] = (val >> 56) & 0xFF;
+        buf[1] = (val >> 48) & 0xFF;
+        buf[2] = (val >> 40) & 0xFF;
+        buf[3] = (val >> 32) & 0xFF;
+        buf[4] = (val >> 24) & 0xFF;
+        buf[5] = (val >> 16) & 0xFF;
+        buf[6] = (val >> 8) & 0xFF;
+        buf[7] = val & 0xFF;
+    }
+
+    inline void OracleAnalyser::writeSCNLittle(uint8_t* buf, typescn val) {
+        if (val < 0x800000000000) {
+            buf[0] = val & 0xFF;
+            buf[1] = (val >> 8) & 0xFF;
+            buf[2] = (val >> 16) & 0xFF;
+            buf[3] = (val >> 24) & 0xFF;
+            buf[4] = (val >> 32) & 0xFF;
+            buf[5] = (val >> 40) & 0xFF;
+        } else {
+            buf[0] = val & 0xFF;
+            buf[1] = (val >> 8) & 0xFF;
+            buf[2] = (val >> 16) & 0xFF;
+            buf[3] = (val >> 24) & 0xFF;
+            buf[4] = (val >> 48) & 0xFF;
+            buf[5] = ((val >> 56) & 0xFF) | 0x80;
+            buf[6] = (val >> 32) & 0xFF;
+            buf[7] = (val >> 40) & 0xFF;
+        }
+    }
+
+    inline void OracleAnalyser::writeSCNBig(uint8_t* buf, typescn val) {
+        if (val < 0x800000000000) {
+            buf[5] = val & 0xFF;
+            buf[4] = (val >> 8) & 0xFF;
+            buf[3] = (val >> 16) & 0xFF;
+            buf[2] = (val >> 24) & 0xFF;
+            buf[1] = (val >> 32) & 0xFF;
+            buf[0] = (val >> 40) & 0xFF;
+        } else {
+            buf[5] = val & 0xFF;
+            buf[4] = (val >> 8) & 0xFF;
+            buf[3] = (val >> 16) & 0xFF;
+            buf[2] = (val >> 24) & 0xFF;
+            buf[1] = (val >> 48) & 0xFF;
+            buf[0] = ((val >> 56) & 0xFF) | 0x80;
+            buf[7] = (val >> 32) & 0xFF;
+            buf[6] = (val >> 40) & 0xFF;
+        }
+    }
+
+    inline uint16_t OracleAnalyser::read16(const uint8_t* buf) const {
+        return isBigEndian ? read16Big(buf) : read16Little(buf);
+    }
+
+    inline uint32_t OracleAnalyser::read32(const uint8_t* buf) const {
+        return isBigEndian ? read32Big(buf) : read32Little(buf);
+    }
+
+    inline uint64_t OracleAnalyser::read56(const uint8_t* buf) const {
+        return isBigEndian ? read56Big(buf) : read56Little(buf);
+    }
+
+    inline uint64_t OracleAnalyser::read64(const uint8_t* buf) const {
+        return isBigEndian ? read64Big(buf) : read64Little(buf);
+    }
+
+    inline typescn OracleAnalyser::readSCN(const uint8_t* buf) const {
+        return isBigEndian ? readSCNBig(buf) : readSCNLittle(buf);
+    }
+
+    inline typescn OracleAnalyser::readSCNr(const uint8_t* buf) const {
+        return isBigEndian ? readSCNrBig(buf) : readSCNrLittle(buf);
+    }
+
+    inline void OracleAnalyser::write16(uint8_t* buf, uint16_t val) const {
+        if (isBigEndian)
+            write16Big(buf, val);
+        else
+            write16Little(buf, val);
+    }
+
+    inline void OracleAnalyser::write32(uint8_t* buf, uint32_t val) const {
+        if (isBigEndian)
+            write32Big(buf, val);
+        else
+            write32Little(buf, val);
+    }
+
+    inline void OracleAnalyser::write56(uint8_t* buf, uint64_t val) const {
+        if (isBigEndian)
+            write56Big(buf, val);
+        else
+            write56Little(buf, val);
+    }
+
+    inline void OracleAnalyser::write64(uint8_t* buf, uint64_t val) const {
+        if (isBigEndian)
+            write64Big(buf, val);
+        else
+            write64Little(buf, val);
+    }
+
+    inline void OracleAnalyser::writeSCN(uint8_t* buf, typescn val) const {
+        if (isBigEndian)
+            writeSCNBig(buf, val);
+        else
+            writeSCNLittle(buf, val);
+    }
 }
 
 #endif
@@ -17,9 +17,12 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <new>
 #include <thread>
 #include <signal.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 
 #include "OpCode0501.h"
 #include "OpCode0502.h"
@@ -40,8 +43,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "OpCode1801.h"
 #include "OracleAnalyser.h"
 #include "OracleAnalyserRedoLog.h"
+#include "OracleAnalyserWorker.h"
 #include "OracleObject.h"
 #include "Reader.h"
+#include "RedoLogDump.h"
 #include "RedoLogException.h"
 #include "RedoLogRecord.h"
 #include "RuntimeException.h"
@@ -67,23 +72,69 @@ namespace OpenLogReplicator {
             recordPos(0),
             recordLeftToCopy(0),
             recordLength4(0),
+            curRecordBlock(0),
+            curRecordPos(0),
+            curRecordLength(0),
             blockNumber(0),
+            blockPosStart(0),
+            indexNextBlock(0),
+            indexMaxScn(0),
+            vectorsProcessed(0),
+            vectorsSkipped(0),
+            suppLogSize(0),
             vectors(0),
+            assemblyThreaded(false),
+            assemblyThread(0),
+            assemblyBuffer(nullptr),
+            assemblyStop(false),
+            assemblyFinished(false),
+            assemblyFailed(false),
+            assemblyRet(REDO_OK),
+            assemblyPushes(0),
+            assemblyQueued(0),
+            assemblyQueuedMax(0),
+            assemblerWaits(0),
+            consumerWaits(0),
+            redoLogDump(nullptr),
+            dumpRender(false),
             group(group),
             path(path),
             sequence(0),
             firstScn(firstScn),
             nextScn(nextScn),
-            reader(nullptr) {
+            reader(nullptr),
+            worker(nullptr),
+            recordBuffer(oracleAnalyser->recordBuffer) {
+        //opcode objects are constructed in place in opCodesBuffer of analyzeRecord
+        static_assert(sizeof(OpCode) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode");
+        static_assert(sizeof(OpCode0501) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0501");
+        static_assert(sizeof(OpCode0502) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0502");
+        static_assert(sizeof(OpCode0504) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0504");
+        static_assert(sizeof(OpCode0506) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0506");
+        static_assert(sizeof(OpCode050B) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode050B");
+        static_assert(sizeof(OpCode0513) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0513");
+        static_assert(sizeof(OpCode0514) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0514");
+        static_assert(sizeof(OpCode0B02) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B02");
+        static_assert(sizeof(OpCode0B03) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B03");
+        static_assert(sizeof(OpCode0B04) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B04");
+        static_assert(sizeof(OpCode0B05) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B05");
+        static_assert(sizeof(OpCode0B06) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B06");
+        static_assert(sizeof(OpCode0B08) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B08");
+        static_assert(sizeof(OpCode0B0B) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B0B");
+        static_assert(sizeof(OpCode0B0C) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B0C");
+        static_assert(sizeof(OpCode0B10) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode0B10");
+        static_assert(sizeof(OpCode1801) <= OPCODE_SIZE_MAX, "opcode buffer too small for OpCode1801");
+
         memset(&zero, 0, sizeof(struct RedoLogRecord));
+        assemblyChunk.data = nullptr;
+        assemblyChunk.size = 0;
+        assemblyChunk.allocated = 0;
     }
 
     OracleAnalyserRedoLog::~OracleAnalyserRedoLog() {
-        for (uint64_t i = 0; i < vectors; ++i) {
-            if (opCodes[i] != nullptr) {
-                delete opCodes[i];
-                opCodes[i] = nullptr;
-            }
+        if (redoLogDump != nullptr) {
+            delete redoLogDump;
+            redoLogDump = nullptr;
         }
     }
 
@@ -259,40 +310,44 @@ namespace OpenLogReplicator {
 
     void OracleAnalyserRedoLog::analyzeRecord(void) {
         RedoLogRecord redoLogRecord[VECTOR_MAX_LENGTH];
+        uint16_t fieldOffsets[FIELD_OFFSETS_RECORD_MAX];
+        uint64_t fieldOffsetsUsed = 0;
+        //opcode objects are constructed in place, destructors release no resources
+        OpCode *opCodes[VECTOR_MAX_LENGTH];
+        uint64_t opCodesBuffer[VECTOR_MAX_LENGTH][OPCODE_SIZE_MAX / sizeof(uint64_t)];
         uint64_t isUndoRedo[VECTOR_MAX_LENGTH];
+        bool skipVector[VECTOR_MAX_LENGTH];
         uint64_t opCodesUndo[VECTOR_MAX_LENGTH / 2];
         uint64_t vectorsUndo = 0;
         uint64_t opCodesRedo[VECTOR_MAX_LENGTH / 2];
         uint64_t vectorsRedo = 0;
 
-        for (uint64_t i = 0; i < vectors; ++i) {
-            if (opCodes[i] != nullptr) {
-                delete opCodes[i];
-                opCodes[i] = nullptr;
-            }
-        }
-
         vectors = 0;
         memset(opCodes, 0, sizeof(opCodes));
-        uint64_t recordLength = oracleAnalyser->read32(oracleAnalyser->recordBuffer);
-        uint8_t vld = oracleAnalyser->recordBuffer[4];
+        uint64_t recordLength = oracleAnalyser->read32(recordBuffer);
+        uint8_t vld = recordBuffer[4];
         curScnPrev = curScn;
-        curScn = oracleAnalyser->read32(oracleAnalyser->recordBuffer + 8) |
-                ((uint64_t)(oracleAnalyser->read16(oracleAnalyser->recordBuffer + 6)) << 32);
-        curSubScn = oracleAnalyser->read16(oracleAnalyser->recordBuffer + 12);
+        curScn = oracleAnalyser->read32(recordBuffer + 8) |
+                ((uint64_t)(oracleAnalyser->read16(recordBuffer + 6)) << 32);
+        curSubScn = oracleAnalyser->read16(recordBuffer + 12);
         uint64_t headerLength;
         uint16_t numChk = 0, numChkMax = 0;
 
-        if (extScn > lastCheckpointScn && curScnPrev != curScn && curScnPrev != ZERO_SCN)
-            flushTransactions(extScn);
+        if (extScn > lastCheckpointScn && curScnPrev != curScn && curScnPrev != ZERO_SCN && !dumpRender) {
+            if (worker != nullptr) {
+                worker->addFlush(extScn);
+                lastCheckpointScn = extScn;
+            } else
+                flushTransactions(extScn);
+        }
 
         if ((vld & 0x04) != 0) {
             headerLength = 68;
-            numChk = oracleAnalyser->read16(oracleAnalyser->recordBuffer + 24);
-            numChkMax = oracleAnalyser->read16(oracleAnalyser->recordBuffer + 26);
-            recordTimestmap = oracleAnalyser->read32(oracleAnalyser->recordBuffer + 64);
+            numChk = oracleAnalyser->read16(recordBuffer + 24);
+            numChkMax = oracleAnalyser->read16(recordBuffer + 26);
+            recordTimestmap = oracleAnalyser->read32(recordBuffer + 64);
             if (numChk + 1 == numChkMax) {
-                extScn = oracleAnalyser->readSCN(oracleAnalyser->recordBuffer + 40);
+                extScn = oracleAnalyser->readSCN(recordBuffer + 40);
             }
             TRACE(TRACE2_DUMP, "C scn: " << PRINTSCN64(curScn) << "." << setfill('0') << setw(4) << hex << curSubScn << " CHECKPOINT at " <<
                     PRINTSCN64(extScn));
@@ -308,16 +363,16 @@ namespace OpenLogReplicator {
             if (oracleAnalyser->version < 0x12100)
                 oracleAnalyser->dumpStream << "REDO RECORD - Thread:" << thread <<
                         " RBA: 0x" << setfill('0') << setw(6) << hex << sequence << "." <<
-                                    setfill('0') << setw(8) << hex << recordBeginBlock << "." <<
-                                    setfill('0') << setw(4) << hex << recordBeginPos <<
+                                    setfill('0') << setw(8) << hex << curRecordBlock << "." <<
+                                    setfill('0') << setw(4) << hex << curRecordPos <<
                         " LEN: 0x" << setfill('0') << setw(4) << hex << recordLength <<
                         " VLD: 0x" << setfill('0') << setw(2) << hex << (uint64_t)vld << endl;
             else {
-                uint32_t conUid = oracleAnalyser->read32(oracleAnalyser->recordBuffer + 16);
+                uint32_t conUid = oracleAnalyser->read32(recordBuffer + 16);
                 oracleAnalyser->dumpStream << "REDO RECORD - Thread:" << thread <<
                         " RBA: 0x" << setfill('0') << setw(6) << hex << sequence << "." <<
-                                    setfill('0') << setw(8) << hex << recordBeginBlock << "." <<
-                                    setfill('0') << setw(4) << hex << recordBeginPos <<
+                                    setfill('0') << setw(8) << hex << curRecordBlock << "." <<
+                                    setfill('0') << setw(4) << hex << curRecordPos <<
                         " LEN: 0x" << setfill('0') << setw(4) << hex << recordLength <<
                         " VLD: 0x" << setfill('0') << setw(2) << hex << (uint64_t)vld <<
                         " CON_UID: " << dec << conUid << endl;
@@ -330,7 +385,7 @@ namespace OpenLogReplicator {
                         oracleAnalyser->dumpStream << endl << "##  " << setfill(' ') << setw(2) << hex << j << ": ";
                     if ((j & 0x07) == 0)
                         oracleAnalyser->dumpStream << " ";
-                    oracleAnalyser->dumpStream << setfill('0') << setw(2) << hex << (uint64_t)oracleAnalyser->recordBuffer[j] << " ";
+                    oracleAnalyser->dumpStream << setfill('0') << setw(2) << hex << (uint64_t)recordBuffer[j] << " ";
                 }
                 oracleAnalyser->dumpStream << endl;
             }
@@ -341,19 +396,19 @@ namespace OpenLogReplicator {
                 else
                     oracleAnalyser->dumpStream << "SCN: " << PRINTSCN64(curScn) << " SUBSCN:" << setfill(' ') << setw(3) << dec << curSubScn << " " << recordTimestmap << endl;
                 uint32_t nst = 1; //FIXME
-                uint32_t lwnLen = oracleAnalyser->read32(oracleAnalyser->recordBuffer + 28);
+                uint32_t lwnLen = oracleAnalyser->read32(recordBuffer + 28);
 
                 if (oracleAnalyser->version < 0x12200)
                     oracleAnalyser->dumpStream << "(LWN RBA: 0x" << setfill('0') << setw(6) << hex << sequence << "." <<
-                                    setfill('0') << setw(8) << hex << recordBeginBlock << "." <<
-                                    setfill('0') << setw(4) << hex << recordBeginPos <<
+                                    setfill('0') << setw(8) << hex << curRecordBlock << "." <<
+                                    setfill('0') << setw(4) << hex << curRecordPos <<
                         " LEN: " << setfill('0') << setw(4) << dec << lwnLen <<
                         " NST: " << setfill('0') << setw(4) << dec << nst <<
                         " SCN: " << PRINTSCN48(extScn) << ")" << endl;
                 else
                     oracleAnalyser->dumpStream << "(LWN RBA: 0x" << setfill('0') << setw(6) << hex << sequence << "." <<
-                                    setfill('0') << setw(8) << hex << recordBeginBlock << "." <<
-                                    setfill('0') << setw(4) << hex << recordBeginPos <<
+                                    setfill('0') << setw(8) << hex << curRecordBlock << "." <<
+                                    setfill('0') << setw(4) << hex << curRecordPos <<
                         " LEN: 0x" << setfill('0') << setw(8) << hex << lwnLen <<
                         " NST: 0x" << setfill('0') << setw(4) << hex << nst <<
                         " SCN: " << PRINTSCN64(extScn) << ")" << endl;
@@ -374,20 +429,20 @@ namespace OpenLogReplicator {
         while (pos < recordLength) {
             memset(&redoLogRecord[vectors], 0, sizeof(struct RedoLogRecord));
             redoLogRecord[vectors].vectorNo = vectors + 1;
-            redoLogRecord[vectors].cls = oracleAnalyser->read16(oracleAnalyser->recordBuffer + pos + 2);
-            redoLogRecord[vectors].afn = oracleAnalyser->read32(oracleAnalyser->recordBuffer + pos + 4) & 0xFFFF;
-            redoLogRecord[vectors].dba = oracleAnalyser->read32(oracleAnalyser->recordBuffer + pos + 8);
-            redoLogRecord[vectors].scnRecord = oracleAnalyser->readSCN(oracleAnalyser->recordBuffer + pos + 12);
+            redoLogRecord[vectors].cls = oracleAnalyser->read16(recordBuffer + pos + 2);
+            redoLogRecord[vectors].afn = oracleAnalyser->read32(recordBuffer + pos + 4) & 0xFFFF;
+            redoLogRecord[vectors].dba = oracleAnalyser->read32(recordBuffer + pos + 8);
+            redoLogRecord[vectors].scnRecord = oracleAnalyser->readSCN(recordBuffer + pos + 12);
             redoLogRecord[vectors].rbl = 0; //FIXME
-            redoLogRecord[vectors].seq = oracleAnalyser->recordBuffer[pos + 20];
-            redoLogRecord[vectors].typ = oracleAnalyser->recordBuffer[pos + 21];
+            redoLogRecord[vectors].seq = recordBuffer[pos + 20];
+            redoLogRecord[vectors].typ = recordBuffer[pos + 21];
             int16_t usn = (redoLogRecord[vectors].cls >= 15) ? (redoLogRecord[vectors].cls - 15) / 2 : -1;
 
             uint64_t fieldOffset;
             if (oracleAnalyser->version >= 0x12100) {
                 fieldOffset = 32;
-                redoLogRecord[vectors].flgRecord = oracleAnalyser->read16(oracleAnalyser->recordBuffer + pos + 28);
-                redoLogRecord[vectors].conId = oracleAnalyser->read16(oracleAnalyser->recordBuffer + pos + 24);
+                redoLogRecord[vectors].flgRecord = oracleAnalyser->read16(recordBuffer + pos + 28);
+                redoLogRecord[vectors].conId = oracleAnalyser->read16(recordBuffer + pos + 24);
             } else {
                 fieldOffset = 24;
                 redoLogRecord[vectors].flgRecord = 0;
@@ -399,15 +454,15 @@ namespace OpenLogReplicator {
                 REDOLOG_FAIL("position of field list (" << dec << (pos + fieldOffset + 1) << ") outside of record, length: " << recordLength);
             }
 
-            uint8_t *fieldList = oracleAnalyser->recordBuffer + pos + fieldOffset;
+            uint8_t *fieldList = recordBuffer + pos + fieldOffset;
 
-            redoLogRecord[vectors].opCode = (((typeop1)oracleAnalyser->recordBuffer[pos + 0]) << 8) |
-                    oracleAnalyser->recordBuffer[pos + 1];
+            redoLogRecord[vectors].opCode = (((typeop1)recordBuffer[pos + 0]) << 8) |
+                    recordBuffer[pos + 1];
             redoLogRecord[vectors].length = fieldOffset + ((oracleAnalyser->read16(fieldList) + 2) & 0xFFFC);
             redoLogRecord[vectors].scn = curScn;
             redoLogRecord[vectors].subScn = curSubScn;
             redoLogRecord[vectors].usn = usn;
-            redoLogRecord[vectors].data = oracleAnalyser->recordBuffer + pos;
+            redoLogRecord[vectors].data = recordBuffer + pos;
             redoLogRecord[vectors].fieldLengthsDelta = fieldOffset;
             redoLogRecord[vectors].fieldCnt = (oracleAnalyser->read16(redoLogRecord[vectors].data + redoLogRecord[vectors].fieldLengthsDelta) - 2) / 2;
             redoLogRecord[vectors].fieldPos = fieldOffset + ((oracleAnalyser->read16(redoLogRecord[vectors].data + redoLogRecord[vectors].fieldLengthsDelta) + 2) & 0xFFFC);
@@ -434,6 +489,9 @@ namespace OpenLogReplicator {
                 REDOLOG_FAIL("incomplete record, pos: " << dec << redoLogRecord[vectors].fieldPos << ", length: " << redoLogRecord[vectors].length);
             }
 
+            //field offsets of all vectors share one table, fields after it is full are found by walking lengths
+            oracleAnalyser->buildFieldOffsets(&redoLogRecord[vectors], fieldOffsets + fieldOffsetsUsed, FIELD_OFFSETS_RECORD_MAX - fieldOffsetsUsed);
+            fieldOffsetsUsed += redoLogRecord[vectors].fieldOffsetsCnt;
             redoLogRecord[vectors].recordObjn = 0xFFFFFFFF;
             redoLogRecord[vectors].recordObjd = 0xFFFFFFFF;
 
@@ -441,129 +499,75 @@ namespace OpenLogReplicator {
 
             switch (redoLogRecord[vectors].opCode) {
             case 0x0501: //Undo
-                opCodes[vectors] = new OpCode0501(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0501) << " bytes memory for (reason: OP 5.1)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0501(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0502: //Begin transaction
-                opCodes[vectors] = new OpCode0502(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0502) << " bytes memory for (reason: OP 5.2)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0502(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0504: //Commit/rollback transaction
-                opCodes[vectors] = new OpCode0504(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0504) << " bytes memory for (reason: OP 5.4)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0504(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0506: //Partial rollback
-                opCodes[vectors] = new OpCode0506(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0506) << " bytes memory for (reason: OP 5.6)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0506(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x050B:
-                opCodes[vectors] = new OpCode050B(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode050B) << " bytes memory for (reason: OP 5.11)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode050B(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0513: //Session information
-                opCodes[vectors] = new OpCode0513(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0513) << " bytes memory for (reason: OP 5.19)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0513(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0514: //Session information
-                opCodes[vectors] = new OpCode0514(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0514) << " bytes memory for (reason: OP 5.20)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0514(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B02: //REDO: Insert row piece
-                opCodes[vectors] = new OpCode0B02(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B02) << " bytes memory for (reason: OP 11.2)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B02(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B03: //REDO: Delete row piece
-                opCodes[vectors] = new OpCode0B03(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B03) << " bytes memory for (reason: OP 11.3)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B03(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B04: //REDO: Lock row piece
-                opCodes[vectors] = new OpCode0B04(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B04) << " bytes memory for (reason: OP 11.4)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B04(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B05: //REDO: Update row piece
-                opCodes[vectors] = new OpCode0B05(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B05) << " bytes memory for (reason: OP 11.5)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B05(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B06: //REDO: Overwrite row piece
-                opCodes[vectors] = new OpCode0B06(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B06) << " bytes memory for (reason: OP 11.6)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B06(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B08: //REDO: Change forwarding address
-                opCodes[vectors] = new OpCode0B08(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B08) << " bytes memory for (reason: OP 11.8)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B08(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B0B: //REDO: Insert multiple rows
-                opCodes[vectors] = new OpCode0B0B(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B0B) << " bytes memory for (reason: OP 11.11)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B0B(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B0C: //REDO: Delete multiple rows
-                opCodes[vectors] = new OpCode0B0C(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B0C) << " bytes memory for (reason: OP 11.12)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B0C(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x0B10: //REDO: Supplemental log for update
-                opCodes[vectors] = new OpCode0B10(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode0B10) << " bytes memory for (reason: OP 11.16)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode0B10(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             case 0x1801: //DDL
-                opCodes[vectors] = new OpCode1801(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode1801) << " bytes memory for (reason: OP 24.1)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode1801(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
 
             default:
-                opCodes[vectors] = new OpCode(oracleAnalyser, &redoLogRecord[vectors]);
-                if (opCodes[vectors] == nullptr) {
-                    RUNTIME_FAIL("could not allocate " << dec << sizeof(OpCode) << " bytes memory for (reason: OP)");
-                }
+                opCodes[vectors] = new(opCodesBuffer[vectors]) OpCode(oracleAnalyser, &redoLogRecord[vectors]);
                 break;
             }
 
@@ -592,12 +596,43 @@ namespace OpenLogReplicator {
             ++vectors;
         }
 
+        vectorsProcessed += vectors;
+        for (uint64_t i = 0; i < vectors; ++i)
+            skipVector[i] = false;
+
+        //objn of undo vector is known from header, skip full decode of vectors for objects which are not replicated
+        if (oracleAnalyser->dumpRedoLog == 0) {
+            for (uint64_t i = 0; i < vectorsUndo; ++i) {
+                RedoLogRecord *undoRecord = &redoLogRecord[opCodesUndo[i]];
+                if (undoRecord->objd == 0 || oracleAnalyser->checkDict(undoRecord->objn, undoRecord->objd) != nullptr)
+                    continue;
+
+                skipVector[opCodesUndo[i]] = true;
+                ++vectorsSkipped;
+                if (i < vectorsRedo) {
+                    skipVector[opCodesRedo[i]] = true;
+                    ++vectorsSkipped;
+                }
+            }
+        }
+
         for (uint64_t i = 0; i < vectors; ++i) {
-            opCodes[i]->process();
-            delete opCodes[i];
+            if (!skipVector[i]) {
+                opCodes[i]->process();
+                suppLogSize += redoLogRecord[i].suppLogSize;
+            }
+            opCodes[i]->~OpCode();
             opCodes[i] = nullptr;
         }
 
+        //rendering of binary dump, no transactions
+        if (dumpRender)
+            return;
+
+        if (worker != nullptr)
+            worker->beginRecord(curScn, recordTimestmap, sizeof(CatchUpEntry) +
+                    vectors * (sizeof(uint64_t) + sizeof(RedoLogRecord) + 8) + recordLength);
+
         uint64_t iPair = 0;
         for (uint64_t i = 0; i < vectors; ++i) {
             //begin transaction
@@ -614,7 +649,11 @@ namespace OpenLogReplicator {
                 appendToTransaction(&redoLogRecord[i]);
 
             } else if (iPair < vectorsUndo) {
-                if (opCodesUndo[iPair] == i) {
+                //object not replicated
+                if (skipVector[i]) {
+                    if (opCodesUndo[iPair] == i || opCodesRedo[iPair] == i)
+                        ++iPair;
+                } else if (opCodesUndo[iPair] == i) {
                     if (iPair < vectorsRedo)
                         appendToTransaction(&redoLogRecord[opCodesUndo[iPair]], &redoLogRecord[opCodesRedo[iPair]]);
                     else
@@ -629,9 +668,20 @@ namespace OpenLogReplicator {
                 }
             }
         }
+
+        if (worker != nullptr)
+            worker->commitRecord();
     }
 
     void OracleAnalyserRedoLog::appendToTransaction(RedoLogRecord *redoLogRecord) {
+        //decoding only, transactions are updated by analyser
+        if (worker != nullptr) {
+            if (redoLogRecord->opCode == 0x1801 || redoLogRecord->opCode == 0x0501 || redoLogRecord->opCode == 0x0502 ||
+                    redoLogRecord->opCode == 0x0504)
+                worker->addItem(redoLogRecord, nullptr);
+            return;
+        }
+
         TRACE(TRACE2_DUMP, *redoLogRecord);
 
         //DDL
@@ -644,17 +694,21 @@ namespace OpenLogReplicator {
             if ((oracleAnalyser->flags & REDO_FLAGS_TRACK_DDL) == 0)
                 return;
 
+            //already included in the dictionary
+            if (redoLogRecord->scn <= oracleAnalyser->databaseScn)
+                return;
+
             redoLogRecord->object = oracleAnalyser->checkDict(redoLogRecord->objn, redoLogRecord->objd);
             if (redoLogRecord->object == nullptr || redoLogRecord->object->options != 0)
                 return;
 
-            Transaction *transaction = oracleAnalyser->xidTransactionMap[redoLogRecord->xid];
+            Transaction *transaction = oracleAnalyser->xidTransactionMap.get(redoLogRecord->xid);
             if (transaction == nullptr) {
                 transaction = new Transaction(oracleAnalyser, redoLogRecord->xid);
                 if (transaction == nullptr) {
                     RUNTIME_FAIL("could not allocate " << dec << sizeof(Transaction) << " bytes memory for (reason: append to transaction#1)");
                 }
-                oracleAnalyser->xidTransactionMap[redoLogRecord->xid] = transaction;
+                oracleAnalyser->xidTransactionMap.set(redoLogRecord->xid, transaction);
 
                 transaction->add(redoLogRecord, &zero, sequence, curScn);
                 oracleAnalyser->transactionHeap->add(transaction);
@@ -680,13 +734,13 @@ namespace OpenLogReplicator {
         if (redoLogRecord->opCode != 0x0502 && redoLogRecord->opCode != 0x0504)
             return;
 
-        Transaction *transaction = oracleAnalyser->xidTransactionMap[redoLogRecord->xid];
+        Transaction *transaction = oracleAnalyser->xidTransactionMap.get(redoLogRecord->xid);
         if (transaction == nullptr) {
             transaction = new Transaction(oracleAnalyser, redoLogRecord->xid);
             if (transaction == nullptr) {
                 RUNTIME_FAIL("could not allocate " << dec << sizeof(Transaction) << " bytes memory for (reason: append to transaction#2)");
             }
-            oracleAnalyser->xidTransactionMap[redoLogRecord->xid] = transaction;
+            oracleAnalyser->xidTransactionMap.set(redoLogRecord->xid, transaction);
 
             transaction->touch(curScn, sequence);
             oracleAnalyser->transactionHeap->add(transaction);
@@ -712,6 +766,11 @@ namespace OpenLogReplicator {
 
     void OracleAnalyserRedoLog::appendToTransaction(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
         bool shutdown = false;
+        if (worker != nullptr) {
+            worker->addItem(redoLogRecord1, redoLogRecord2);
+            return;
+        }
+
         TRACE(TRACE2_DUMP, *redoLogRecord1);
         TRACE(TRACE2_DUMP, *redoLogRecord2);
 
@@ -790,13 +849,13 @@ namespace OpenLogReplicator {
                     break;
                 }
 
-                Transaction *transaction = oracleAnalyser->xidTransactionMap[redoLogRecord1->xid];
+                Transaction *transaction = oracleAnalyser->xidTransactionMap.get(redoLogRecord1->xid);
                 if (transaction == nullptr) {
                     transaction = new Transaction(oracleAnalyser, redoLogRecord1->xid);
                     if (transaction == nullptr) {
                         RUNTIME_FAIL("could not allocate " << dec << sizeof(Transaction) << " bytes memory for (reason: append to transaction#3)");
                     }
-                    oracleAnalyser->xidTransactionMap[redoLogRecord1->xid] = transaction;
+                    oracleAnalyser->xidTransactionMap.set(redoLogRecord1->xid, transaction);
 
                     //process split block
                     if ((redoLogRecord1->flg & (FLG_MULTIBLOCKUNDOHEAD | FLG_MULTIBLOCKUNDOMID | FLG_MULTIBLOCKUNDOTAIL)) != 0)
@@ -859,18 +918,33 @@ namespace OpenLogReplicator {
                     if (transaction->opCodes > 0)
                         oracleAnalyser->lastOpTransactionMap->set(transaction);
                 } else {
-                    //check all previous transactions
+                    //check the transaction which added the operation earlier
                     bool foundPrevious = false;
+                    RollbackIndexEntry entry = oracleAnalyser->rollbackIndex.get(ROLLBACK_KEY(redoLogRecord1->uba, redoLogRecord2->slt));
+                    if (entry.xid != 0)
+                        transaction = oracleAnalyser->xidTransactionMap.get(entry.xid);
 
-                    for (uint64_t i = 1; i <= oracleAnalyser->transactionHeap->size; ++i) {
-                        transaction = oracleAnalyser->transactionHeap->at(i);
+                    if (transaction != nullptr && transaction->opCodes > 0 &&
+                            transaction->rollbackPartOp(redoLogRecord1, redoLogRecord2, curScn)) {
+                        oracleAnalyser->printRollbackInfo(redoLogRecord1, redoLogRecord2, transaction, "partial match, rolled back");
+                        oracleAnalyser->transactionHeap->update(transaction->pos);
+                        foundPrevious = true;
+                    }
 
-                        if (transaction->opCodes > 0 &&
-                                transaction->rollbackPartOp(redoLogRecord1, redoLogRecord2, curScn)) {
-                            oracleAnalyser->printRollbackInfo(redoLogRecord1, redoLogRecord2, transaction, "partial match, rolled back");
-                            oracleAnalyser->transactionHeap->update(transaction->pos);
-                            foundPrevious = true;
-                            break;
+                    //operations of spilled chunks are not indexed, search transactions which have them
+                    if (!foundPrevious && oracleAnalyser->transactionBuffer->spilledTransactions > 0) {
+                        for (auto &entry : oracleAnalyser->xidTransactionMap) {
+                            Transaction *spilledTransaction = entry.value;
+                            if (spilledTransaction == transaction || spilledTransaction->spillEntries.size() == 0 ||
+                                    spilledTransaction->opCodes == 0)
+                                continue;
+
+                            if (spilledTransaction->rollbackPartOp(redoLogRecord1, redoLogRecord2, curScn)) {
+                                oracleAnalyser->printRollbackInfo(redoLogRecord1, redoLogRecord2, spilledTransaction, "partial match, rolled back");
+                                oracleAnalyser->transactionHeap->update(spilledTransaction->pos);
+                                foundPrevious = true;
+                                break;
+                            }
                         }
                     }
 
@@ -890,13 +964,13 @@ namespace OpenLogReplicator {
         if (oracleAnalyser->trace >= TRACE_WARNING) {
             stringstream ss;
             ss << "WARNING: Dumping redo Vector" << endl;
-            ss << "WARNING: ##: " << dec << recordLength4;
-            for (uint64_t j = 0; j < recordLength4; ++j) {
+            ss << "WARNING: ##: " << dec << curRecordLength;
+            for (uint64_t j = 0; j < curRecordLength; ++j) {
                 if ((j & 0x0F) == 0)
                     ss << endl << "WARNING: ##  " << setfill(' ') << setw(2) << hex << j << ": ";
                 if ((j & 0x07) == 0)
                     ss << " ";
-                ss << setfill('0') << setw(2) << hex << (uint64_t)oracleAnalyser->recordBuffer[j] << " ";
+                ss << setfill('0') << setw(2) << hex << (uint64_t)recordBuffer[j] << " ";
             }
             ss << endl;
             OUT(ss.str());
@@ -946,6 +1020,7 @@ namespace OpenLogReplicator {
             oracleAnalyser->databaseScn = checkpointScn;
         }
         lastCheckpointScn = checkpointScn;
+        oracleAnalyser->expireRollbackList(checkpointScn);
 
         if (shutdownInstructed)
             stopMain();
@@ -963,7 +1038,13 @@ namespace OpenLogReplicator {
         recordPos = 0;
         recordLeftToCopy = 0;
         recordLength4 = 0;
+        curRecordBlock = 0;
+        curRecordPos = 0;
+        curRecordLength = 0;
         blockNumber = 2;
+        blockPosStart = 0;
+        indexNextBlock = 0;
+        indexMaxScn = 0;
     }
 
     void OracleAnalyserRedoLog::continueRedo(OracleAnalyserRedoLog *prev) {
@@ -979,36 +1060,160 @@ namespace OpenLogReplicator {
         recordLeftToCopy = prev->recordLeftToCopy;
         recordLength4 = prev->recordLength4;
         blockNumber = prev->blockNumber;
+        blockPosStart = 0;
+        indexNextBlock = prev->indexNextBlock;
+        indexMaxScn = prev->indexMaxScn;
 
-        reader->bufferStart = prev->reader->bufferStart;
-        reader->bufferEnd = prev->reader->bufferEnd;
+        reader->bufferStart = prev->reader->bufferStart.load();
+        reader->bufferEnd = prev->reader->bufferEnd.load();
     }
 
-    uint64_t OracleAnalyserRedoLog::processLog(void) {
-        if (firstScn == ZERO_SCN && nextScn == ZERO_SCN && reader->firstScn != 0) {
-            firstScn = reader->firstScn;
-            nextScn = reader->nextScn;
+    bool OracleAnalyserRedoLog::seek(typescn scn) {
+        if ((oracleAnalyser->flags & REDO_FLAGS_INDEX) == 0)
+            return false;
+
+        string name = oracleAnalyser->getIndexFileName(sequence);
+        ifstream infile;
+        infile.open(name.c_str(), ios::in | ios::binary);
+        if (!infile.is_open())
+            return false;
+
+        RedoLogIndexHeader header;
+        if (!infile.read((char*)&header, sizeof(header)) || header.magic != INDEX_MAGIC || header.sequence != sequence ||
+                header.firstScn != reader->firstScn || header.blockSize != reader->blockSize) {
+            WARNING("redo log index " << name << " does not match redo log: " << path << ", reading from start");
+            return false;
         }
-        INFO("processing redo log: " << *this);
-        uint64_t blockPos = 16, bufferPos = 0, blockNumberStart = blockNumber;
-        uint64_t curBufferStart = 0, curBufferEnd = 0, curRet, curStatus;
-        oracleAnalyser->suppLogSize = 0;
 
-        if (reader->bufferStart == reader->blockSize * 2) {
-            if (oracleAnalyser->dumpRedoLog >= 1) {
-                stringstream name;
-                name << oracleAnalyser->databaseContext.c_str() << "-" << dec << sequence << ".logdump";
-                oracleAnalyser->dumpStream.open(name.str());
-                if (!oracleAnalyser->dumpStream.is_open()) {
-                    WARNING("can't open " << name.str() << " for write. Aborting log dump.");
-                    oracleAnalyser->dumpRedoLog = 0;
-                }
-                printHeaderInfo();
+        //last position before which all records have lower SCN
+        RedoLogIndexEntry entry, entryFound;
+        entryFound.block = 0;
+        uint64_t lastBlock = 0;
+        while (infile.read((char*)&entry, sizeof(entry))) {
+            if (entry.maxScn < scn && entry.block > entryFound.block)
+                entryFound = entry;
+            if (entry.block > lastBlock)
+                lastBlock = entry.block;
+        }
+        infile.close();
+
+        if (entryFound.block <= blockNumber)
+            return false;
+
+        INFO("seeking redo log: " << path << " to block: " << dec << entryFound.block << " offset: " << dec << entryFound.pos <<
+                " for scn: " << PRINTSCN64(scn));
+        blockNumber = entryFound.block;
+        blockPosStart = entryFound.pos;
+        indexMaxScn = entryFound.maxScn;
+        indexNextBlock = lastBlock + INDEX_INTERVAL / reader->blockSize;
+        reader->bufferStart = blockNumber * reader->blockSize;
+        reader->bufferEnd = blockNumber * reader->blockSize;
+        return true;
+    }
+
+    void OracleAnalyserRedoLog::indexOpen(void) {
+        string name = oracleAnalyser->getIndexFileName(sequence);
+
+        if (blockNumber == 2) {
+            indexStream.open(name.c_str(), ios::out | ios::trunc | ios::binary);
+            if (!indexStream.is_open()) {
+                WARNING("can't open " << name << " for write, redo log index is not created");
+                return;
             }
+
+            RedoLogIndexHeader header;
+            header.magic = INDEX_MAGIC;
+            header.sequence = sequence;
+            header.firstScn = reader->firstScn;
+            header.blockSize = reader->blockSize;
+            indexStream.write((char*)&header, sizeof(header));
+            indexNextBlock = 2;
+        } else {
+            //continue index written before seek or before online redo log was overwritten
+            struct stat fileStat;
+            if (stat(name.c_str(), &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(RedoLogIndexHeader))
+                return;
+            indexStream.open(name.c_str(), ios::out | ios::app | ios::binary);
+        }
+    }
+
+    void OracleAnalyserRedoLog::indexRecord(void) {
+        if (curRecordBlock >= indexNextBlock) {
+            RedoLogIndexEntry entry;
+            entry.block = curRecordBlock;
+            entry.pos = curRecordPos;
+            entry.maxScn = indexMaxScn;
+            indexStream.write((char*)&entry, sizeof(entry));
+            indexNextBlock = curRecordBlock + INDEX_INTERVAL / reader->blockSize;
+        }
+
+        if (curScn != ZERO_SCN && curScn > indexMaxScn)
+            indexMaxScn = curScn;
+    }
+
+    void OracleAnalyserRedoLog::processRecord(void) {
+        if (redoLogDump != nullptr)
+            redoLogDump->addRecord(recordBuffer, curRecordLength, curRecordBlock, curRecordPos);
+
+        try {
+            analyzeRecord();
+        } catch(RedoLogException &ex) {
+            if ((oracleAnalyser->flags & REDO_FLAGS_ON_ERROR_CONTINUE) == 0) {
+                RUNTIME_FAIL("runtime error, aborting further redo log processing");
+            } else
+                WARNING("forced to continue working in spite of error");
+        }
+
+        if (indexStream.is_open())
+            indexRecord();
+    }
+
+    void *OracleAnalyserRedoLog::assembleStatic(void *context) {
+        ((OracleAnalyserRedoLog *) context)->assemble();
+        return 0;
+    }
+
+    void OracleAnalyserRedoLog::assemble(void) {
+        TRACE(TRACE2_THREADS, "ASSEMBLY (" << hex << this_thread::get_id() << ") START");
+        uint64_t curRet = REDO_ERROR;
+        bool failed = false;
+
+        try {
+            curRet = assembleLog();
+            assemblyPush();
+        } catch(RedoLogException &ex) {
+            failed = true;
+        } catch(RuntimeException &ex) {
+            failed = true;
         }
 
-        clock_t cStart = clock();
         {
+            unique_lock<mutex> lck(assemblyMtx);
+            assemblyRet = curRet;
+            assemblyFailed = failed;
+            assemblyFinished = true;
+            consumerCond.notify_all();
+        }
+
+        TRACE(TRACE2_THREADS, "ASSEMBLY (" << hex << this_thread::get_id() << ") STOP");
+    }
+
+    //walks redo blocks and copies records to continuous memory, records are analyzed or queued for the analyser
+    uint64_t OracleAnalyserRedoLog::assembleLog(void) {
+        uint64_t blockPos = 16, bufferPos = 0;
+        uint64_t curBufferStart = 0, curBufferEnd = 0, curRet = REDO_OK, curStatus;
+        uint8_t *recordData = assemblyBuffer;
+
+        //record started in previous redo log
+        if (assemblyThreaded && recordLeftToCopy > 0) {
+            recordData = assemblyReserve(recordLength4);
+            memcpy(recordData, assemblyBuffer, recordPos);
+        }
+
+        if (reader->redoMap != nullptr) {
+            //whole file is mapped, blocks are verified in place without reader thread
+            curBufferEnd = reader->bufferStart;
+        } else {
             unique_lock<mutex> lck(oracleAnalyser->mtx);
             reader->status = READER_STATUS_READ;
             curBufferEnd = reader->bufferEnd;
@@ -1016,44 +1221,73 @@ namespace OpenLogReplicator {
             oracleAnalyser->sleepingCond.notify_all();
         }
         curBufferStart = reader->bufferStart;
-        bufferPos = (blockNumber * reader->blockSize) % DISK_BUFFER_SIZE;
+        bufferPos = (blockNumber * reader->blockSize) % reader->bufferSize;
 
-        while (!oracleAnalyser->shutdown) {
+        while (!oracleAnalyser->shutdown && (worker == nullptr || !worker->shutdown) && !assemblyStop) {
             //there is some work to do
             while (curBufferStart < curBufferEnd) {
                 TRACE(TRACE2_VECTOR, "block " << dec << (curBufferStart / reader->blockSize) << " left: " << dec << recordLeftToCopy << ", last length: "
                             << recordLength4);
 
+                uint8_t *redoBlock;
+                if (reader->redoMap != nullptr)
+                    redoBlock = reader->redoMap + curBufferStart;
+                else
+                    redoBlock = reader->redoBuffer + bufferPos;
+
                 blockPos = 16;
+                //first block after seek starts with a record in the middle
+                if (blockPosStart > 0) {
+                    blockPos = blockPosStart;
+                    blockPosStart = 0;
+                }
                 while (blockPos < reader->blockSize) {
                     //next record
                     if (recordLeftToCopy == 0) {
                         if (blockPos + 20 >= reader->blockSize)
                             break;
 
-                        recordLength4 = (oracleAnalyser->read32(reader->redoBuffer + bufferPos + blockPos) + 3) & 0xFFFFFFFC;
+                        recordLength4 = (oracleAnalyser->read32(redoBlock + blockPos) + 3) & 0xFFFFFFFC;
                         recordLeftToCopy = recordLength4;
                         if (recordLength4 > REDO_RECORD_MAX_SIZE) {
-                            dumpRedoVector();
                             REDOLOG_FAIL("too big log record: " << dec << recordLeftToCopy << " bytes");
                         }
 
                         recordPos = 0;
                         recordBeginPos = blockPos;
                         recordBeginBlock = blockNumber;
+                        if (assemblyThreaded && recordLeftToCopy > 0)
+                            recordData = assemblyReserve(recordLength4);
                     }
 
                     //nothing more
                     if (recordLeftToCopy == 0)
                         break;
 
+                    //record inside one block is analyzed in place, the block is released to the reader after all its records are processed
+                    if (!assemblyThreaded && recordPos == 0 && blockPos + recordLeftToCopy <= reader->blockSize) {
+                        TRACE(TRACE2_VECTOR, "* block: " << dec << recordBeginBlock << " pos: " << dec << recordBeginPos << ", length: " << recordLength4);
+
+                        recordBuffer = redoBlock + blockPos;
+                        blockPos += recordLeftToCopy;
+                        recordPos = recordLeftToCopy;
+                        recordLeftToCopy = 0;
+
+                        curRecordBlock = recordBeginBlock;
+                        curRecordPos = recordBeginPos;
+                        curRecordLength = recordLength4;
+                        processRecord();
+                        recordBuffer = assemblyBuffer;
+                        continue;
+                    }
+
                     uint64_t toCopy;
                     if (blockPos + recordLeftToCopy > reader->blockSize)
                         toCopy = reader->blockSize - blockPos;
                     else
                         toCopy = recordLeftToCopy;
 
-                    memcpy(oracleAnalyser->recordBuffer + recordPos, reader->redoBuffer + bufferPos + blockPos, toCopy);
+                    memcpy(recordData + recordPos, redoBlock + blockPos, toCopy);
                     recordLeftToCopy -= toCopy;
                     blockPos += toCopy;
                     recordPos += toCopy;
@@ -1061,13 +1295,18 @@ namespace OpenLogReplicator {
                     if (recordLeftToCopy == 0) {
                         TRACE(TRACE2_VECTOR, "* block: " << dec << recordBeginBlock << " pos: " << dec << recordBeginPos << ", length: " << recordLength4);
 
-                        try {
-                            analyzeRecord();
-                        } catch(RedoLogException &ex) {
-                            if ((oracleAnalyser->flags & REDO_FLAGS_ON_ERROR_CONTINUE) == 0) {
-                                RUNTIME_FAIL("runtime error, aborting further redo log processing");
-                            } else
-                                WARNING("forced to continue working in spite of error");
+                        if (assemblyThreaded) {
+                            AssemblyEntry *entry = (AssemblyEntry*)(recordData - sizeof(AssemblyEntry));
+                            entry->size = sizeof(AssemblyEntry) + ((recordLength4 + 7) & 0xFFFFFFFFFFFFFFF8);
+                            entry->length = recordLength4;
+                            entry->block = recordBeginBlock;
+                            entry->pos = recordBeginPos;
+                            assemblyChunk.size += entry->size;
+                        } else {
+                            curRecordBlock = recordBeginBlock;
+                            curRecordPos = recordBeginPos;
+                            curRecordLength = recordLength4;
+                            processRecord();
                         }
                     }
                 }
@@ -1075,43 +1314,277 @@ namespace OpenLogReplicator {
                 ++blockNumber;
                 curBufferStart += reader->blockSize;
                 bufferPos += reader->blockSize;
-                if (bufferPos == DISK_BUFFER_SIZE)
+                if (bufferPos == reader->bufferSize)
                     bufferPos = 0;
 
-                if (curBufferStart - reader->bufferStart > DISK_BUFFER_SIZE / 16) {
-                    unique_lock<mutex> lck(oracleAnalyser->mtx);
+                if (reader->redoMap == nullptr && curBufferStart - reader->bufferStart > reader->bufferSize / 16) {
                     reader->bufferStart = curBufferStart;
                     curBufferEnd = reader->bufferEnd;
-                    if (reader->status == READER_STATUS_READ) {
+                    if (reader->readerWaiting) {
+                        unique_lock<mutex> lck(oracleAnalyser->mtx);
                         oracleAnalyser->readerCond.notify_all();
                     }
                 }
 
-                oracleAnalyser->checkForCheckpoint();
+                if (worker == nullptr && !assemblyThreaded)
+                    oracleAnalyser->checkForCheckpoint();
+            }
+
+            if (reader->redoMap != nullptr) {
+                curRet = reader->checkMappedBlocks(curBufferEnd);
+                if (curBufferStart == curBufferEnd)
+                    break;
+                continue;
+            }
+
+            if (reader->bufferStart < curBufferStart) {
+                reader->bufferStart = curBufferStart;
+                if (reader->readerWaiting) {
+                    unique_lock<mutex> lck(oracleAnalyser->mtx);
+                    oracleAnalyser->readerCond.notify_all();
+                }
+            }
+
+            curBufferEnd = reader->bufferEnd;
+            curRet = reader->ret;
+            if (curBufferStart < curBufferEnd)
+                continue;
+
+            //pass records which are already assembled before waiting for the reader
+            if (assemblyThreaded && assemblyChunk.size > 0) {
+                if (recordLeftToCopy > 0) {
+                    //record which is not complete is moved to next chunk
+                    memcpy(assemblyBuffer, recordData, recordPos);
+                    assemblyPush();
+                    recordData = assemblyReserve(recordLength4);
+                    memcpy(recordData, assemblyBuffer, recordPos);
+                } else
+                    assemblyPush();
             }
 
+            //all work done, the reader wakes the analyser only when this flag is set
             {
                 unique_lock<mutex> lck(oracleAnalyser->mtx);
+                reader->analyserWaiting = true;
                 curBufferEnd = reader->bufferEnd;
                 curStatus = reader->status;
                 curRet = reader->ret;
-                if (reader->bufferStart < curBufferStart) {
-                    reader->bufferStart = curBufferStart;
-                    if (reader->status == READER_STATUS_READ) {
-                        oracleAnalyser->readerCond.notify_all();
-                    }
-                }
 
-                //all work done
                 if (curBufferStart == curBufferEnd) {
-                    if (curRet == REDO_FINISHED || curRet == REDO_OVERWRITTEN || curStatus == READER_STATUS_SLEEPING)
+                    if (curRet == REDO_FINISHED || curRet == REDO_OVERWRITTEN || curStatus == READER_STATUS_SLEEPING || assemblyStop) {
+                        reader->analyserWaiting = false;
                         break;
+                    }
+                    ++reader->analyserWaits;
                     oracleAnalyser->analyserCond.wait(lck);
                 }
+                reader->analyserWaiting = false;
             }
         }
 
-        if (curRet == REDO_FINISHED && curScn != ZERO_SCN) {
+        //record is continued in next redo log
+        if (assemblyThreaded && recordLeftToCopy > 0)
+            memcpy(assemblyBuffer, recordData, recordPos);
+
+        return curRet;
+    }
+
+    uint8_t *OracleAnalyserRedoLog::assemblyReserve(uint64_t size) {
+        size = sizeof(AssemblyEntry) + ((size + 7) & 0xFFFFFFFFFFFFFFF8);
+        uint64_t capacity = (assemblyChunk.allocated > 0) ? assemblyChunk.allocated : MEMORY_CHUNK_SIZE;
+        if (assemblyChunk.data != nullptr && assemblyChunk.size + size > capacity) {
+            if (assemblyChunk.size > 0)
+                assemblyPush();
+            else
+                assemblyFree(assemblyChunk);
+        }
+
+        if (assemblyChunk.data == nullptr) {
+            //record which does not fit in memory chunk
+            if (size > MEMORY_CHUNK_SIZE) {
+                assemblyChunk.data = new uint8_t[size];
+                if (assemblyChunk.data == nullptr) {
+                    RUNTIME_FAIL("could not allocate " << dec << size << " bytes memory for (reason: record assembly buffer)");
+                }
+                assemblyChunk.allocated = size;
+            } else {
+                assemblyChunk.data = oracleAnalyser->getMemoryChunk("ASSEMBLY", false);
+                assemblyChunk.allocated = 0;
+            }
+            assemblyChunk.size = 0;
+        }
+
+        return assemblyChunk.data + assemblyChunk.size + sizeof(AssemblyEntry);
+    }
+
+    void OracleAnalyserRedoLog::assemblyPush(void) {
+        if (assemblyChunk.data == nullptr || assemblyChunk.size == 0)
+            return;
+
+        {
+            unique_lock<mutex> lck(assemblyMtx);
+            while (assemblyChunks.size() >= ASSEMBLY_CHUNKS_MAX && !assemblyStop) {
+                ++assemblerWaits;
+                assemblerCond.wait(lck);
+            }
+
+            assemblyChunks.push(assemblyChunk);
+            ++assemblyPushes;
+            assemblyQueued += assemblyChunks.size();
+            if (assemblyChunks.size() > assemblyQueuedMax)
+                assemblyQueuedMax = assemblyChunks.size();
+            consumerCond.notify_all();
+        }
+
+        assemblyChunk.data = nullptr;
+        assemblyChunk.size = 0;
+        assemblyChunk.allocated = 0;
+    }
+
+    bool OracleAnalyserRedoLog::assemblyGet(AssemblyChunk &chunk) {
+        unique_lock<mutex> lck(assemblyMtx);
+        while (assemblyChunks.empty()) {
+            if (assemblyFinished)
+                return false;
+            ++consumerWaits;
+            consumerCond.wait(lck);
+        }
+
+        chunk = assemblyChunks.front();
+        assemblyChunks.pop();
+        assemblerCond.notify_all();
+        return true;
+    }
+
+    void OracleAnalyserRedoLog::assemblyFree(AssemblyChunk &chunk) {
+        if (chunk.allocated > 0)
+            delete[] chunk.data;
+        else
+            oracleAnalyser->freeMemoryChunk("ASSEMBLY", chunk.data, false);
+        chunk.data = nullptr;
+        chunk.size = 0;
+        chunk.allocated = 0;
+    }
+
+    void OracleAnalyserRedoLog::assemblyStart(void) {
+        assemblyThreaded = true;
+        assemblyStop = false;
+        assemblyFinished = false;
+        assemblyFailed = false;
+        assemblyRet = REDO_OK;
+        assemblyPushes = 0;
+        assemblyQueued = 0;
+        assemblyQueuedMax = 0;
+        assemblerWaits = 0;
+        consumerWaits = 0;
+
+        if (pthread_create(&assemblyThread, nullptr, &OracleAnalyserRedoLog::assembleStatic, (void*)this)) {
+            assemblyThreaded = false;
+            RUNTIME_FAIL("spawning thread - record assembly");
+        }
+    }
+
+    void OracleAnalyserRedoLog::assemblyEnd(void) {
+        {
+            unique_lock<mutex> lck(assemblyMtx);
+            assemblyStop = true;
+            assemblerCond.notify_all();
+        }
+        {
+            unique_lock<mutex> lck(oracleAnalyser->mtx);
+            oracleAnalyser->analyserCond.notify_all();
+        }
+        pthread_join(assemblyThread, nullptr);
+
+        while (!assemblyChunks.empty()) {
+            AssemblyChunk chunk = assemblyChunks.front();
+            assemblyChunks.pop();
+            assemblyFree(chunk);
+        }
+        if (assemblyChunk.data != nullptr)
+            assemblyFree(assemblyChunk);
+
+        assemblyThreaded = false;
+        recordBuffer = assemblyBuffer;
+    }
+
+    uint64_t OracleAnalyserRedoLog::analyzeAssembled(void) {
+        AssemblyChunk chunk;
+
+        while (assemblyGet(chunk)) {
+            uint64_t pos = 0;
+            while (pos < chunk.size) {
+                AssemblyEntry *entry = (AssemblyEntry*)(chunk.data + pos);
+                pos += entry->size;
+
+                recordBuffer = ((uint8_t*)entry) + sizeof(AssemblyEntry);
+                curRecordBlock = entry->block;
+                curRecordPos = entry->pos;
+                curRecordLength = entry->length;
+                processRecord();
+            }
+
+            assemblyFree(chunk);
+            if (worker == nullptr)
+                oracleAnalyser->checkForCheckpoint();
+        }
+
+        if (assemblyFailed) {
+            RUNTIME_FAIL("record assembly failed, aborting further redo log processing");
+        }
+        return assemblyRet;
+    }
+
+    uint64_t OracleAnalyserRedoLog::processLog(void) {
+        if (firstScn == ZERO_SCN && nextScn == ZERO_SCN && reader->firstScn != 0) {
+            firstScn = reader->firstScn;
+            nextScn = reader->nextScn;
+        }
+        INFO("processing redo log: " << *this);
+        uint64_t blockNumberStart = blockNumber, curRet;
+        suppLogSize = 0;
+        vectorsProcessed = 0;
+        vectorsSkipped = 0;
+
+        if (reader->bufferStart == reader->blockSize * 2) {
+            if (oracleAnalyser->dumpRedoLog >= 1) {
+                stringstream name;
+                name << oracleAnalyser->databaseContext.c_str() << "-" << dec << sequence << ".logdump";
+                oracleAnalyser->dumpStream.open(name.str());
+                if (!oracleAnalyser->dumpStream.is_open()) {
+                    WARNING("can't open " << name.str() << " for write. Aborting log dump.");
+                    oracleAnalyser->dumpRedoLog = 0;
+                }
+                printHeaderInfo();
+            } else if ((oracleAnalyser->flags & REDO_FLAGS_DUMP_BINARY) != 0)
+                dumpOpen();
+        }
+
+        if ((oracleAnalyser->flags & REDO_FLAGS_INDEX) != 0)
+            indexOpen();
+
+        //cpu time of this thread, clock() would sum all catch-up workers
+        struct timespec timeStart, timeEnd;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timeStart);
+        assemblyBuffer = recordBuffer;
+        if ((oracleAnalyser->flags & REDO_FLAGS_ASSEMBLY_THREAD) != 0) {
+            assemblyStart();
+            try {
+                curRet = analyzeAssembled();
+            } catch(RuntimeException &ex) {
+                assemblyEnd();
+                throw;
+            } catch(RedoLogException &ex) {
+                assemblyEnd();
+                throw;
+            }
+            assemblyEnd();
+        } else
+            curRet = assembleLog();
+
+        if (worker != nullptr) {
+            worker->addEnd(curScn, curRet);
+        } else if (curRet == REDO_FINISHED && curScn != ZERO_SCN) {
             Transaction *transaction;
             for (uint64_t i = 1; i <= oracleAnalyser->transactionHeap->size; ++i) {
                 transaction = oracleAnalyser->transactionHeap->at(i);
@@ -1121,21 +1594,210 @@ namespace OpenLogReplicator {
             flushTransactions(curScn);
         }
 
-        clock_t cEnd = clock();
-        double mySpeed = 0, myTime = 1000.0 * (cEnd-cStart) / CLOCKS_PER_SEC, suppLogPercent = 0.0;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timeEnd);
+        double mySpeed = 0, myTime = ((timeEnd.tv_sec - timeStart.tv_sec) * 1000000000 + timeEnd.tv_nsec - timeStart.tv_nsec) / 1000000.0,
+                suppLogPercent = 0.0, vectorsSpeed = 0;
         if (blockNumber != blockNumberStart)
-            suppLogPercent = 100.0 * oracleAnalyser->suppLogSize / ((blockNumber - blockNumberStart)* reader->blockSize);
-        if (myTime > 0)
+            suppLogPercent = 100.0 * suppLogSize / ((blockNumber - blockNumberStart)* reader->blockSize);
+        if (myTime > 0) {
             mySpeed = (blockNumber - blockNumberStart) * reader->blockSize / 1024 / 1024 / myTime * 1000;
+            vectorsSpeed = vectorsProcessed / myTime * 1000;
+        }
 
         TRACE(TRACE2_PERFORMANCE, "redo processing time: " << myTime << " ms, " <<
+                "Sequence: " << dec << sequence << ", " <<
                 "Speed: " << fixed << setprecision(2) << mySpeed << " MB/s, " <<
                 "Redo log size: " << dec << ((blockNumber - blockNumberStart) * reader->blockSize / 1024) << " kB, " <<
-                "Supplemental redo log size: " << dec << oracleAnalyser->suppLogSize << " bytes " <<
-                "(" << fixed << setprecision(2) << suppLogPercent << " %)");
+                "Supplemental redo log size: " << dec << suppLogSize << " bytes " <<
+                "(" << fixed << setprecision(2) << suppLogPercent << " %), " <<
+                "Vectors: " << dec << vectorsProcessed << " (" << fixed << setprecision(0) << vectorsSpeed << "/s), " <<
+                "Vectors skipped: " << dec << vectorsSkipped << ", " <<
+                "Reader waits: " << dec << reader->readerWaits << ", Analyser waits: " << dec << reader->analyserWaits);
+        TransactionMap *transactionMap = oracleAnalyser->lastOpTransactionMap;
+        double chainAvg = 0;
+        if (transactionMap->lookups > 0)
+            chainAvg = (double)transactionMap->lookupSteps / transactionMap->lookups;
+        TRACE(TRACE2_PERFORMANCE, "transaction map: " << dec << transactionMap->elements << " elements, " <<
+                dec << transactionMap->buckets << " buckets, load factor: " << fixed << setprecision(2) << transactionMap->loadFactor() << ", " <<
+                "chain avg: " << fixed << setprecision(2) << chainAvg << ", chain max: " << dec << transactionMap->chainMax);
+        if ((oracleAnalyser->flags & REDO_FLAGS_ASSEMBLY_THREAD) != 0) {
+            double queueAvg = 0;
+            if (assemblyPushes > 0)
+                queueAvg = (double)assemblyQueued / assemblyPushes;
+            TRACE(TRACE2_PERFORMANCE, "record assembly queue: " << fixed << setprecision(2) << queueAvg << " avg, " <<
+                    dec << assemblyQueuedMax << " max of " << dec << ASSEMBLY_CHUNKS_MAX << " chunks, " <<
+                    "Chunks: " << dec << assemblyPushes << ", Assembler waits: " << dec << assemblerWaits << ", Analyser waits: " << dec << consumerWaits);
+        }
 
         if (oracleAnalyser->dumpRedoLog >= 1 && oracleAnalyser->dumpStream.is_open())
             oracleAnalyser->dumpStream.close();
+        if (redoLogDump != nullptr)
+            dumpClose();
+        if (indexStream.is_open())
+            indexStream.close();
+
+        return curRet;
+    }
+
+    void OracleAnalyserRedoLog::dumpOpen(void) {
+        stringstream name;
+        name << oracleAnalyser->databaseContext.c_str() << "-" << dec << sequence << ".logdump.bin";
+        string fileName = name.str();
+
+        redoLogDump = new RedoLogDump("dump", oracleAnalyser);
+        if (redoLogDump == nullptr) {
+            RUNTIME_FAIL("could not allocate " << dec << sizeof(RedoLogDump) << " bytes memory for (reason: redo log dump)");
+        }
+
+        if (!redoLogDump->open(fileName, sequence, reader->blockSize)) {
+            WARNING("can't open " << fileName << " for write. Aborting log dump.");
+            delete redoLogDump;
+            redoLogDump = nullptr;
+        }
+    }
+
+    void OracleAnalyserRedoLog::dumpClose(void) {
+        redoLogDump->finish();
+        TRACE(TRACE2_PERFORMANCE, "redo log dump: " << dec << redoLogDump->bytesWritten << " bytes, " <<
+                "Analyser waits: " << dec << redoLogDump->producerWaits);
+
+        delete redoLogDump;
+        redoLogDump = nullptr;
+    }
+
+    //text form of dump created with REDO_FLAGS_DUMP_BINARY, decoded with the same opcode parsers
+    uint64_t OracleAnalyserRedoLog::renderDump(void) {
+        ifstream inputStream(path.c_str(), ios::in | ios::binary);
+        if (!inputStream.is_open()) {
+            WARNING("can't open " << path << " for read. Skipping log dump.");
+            return REDO_ERROR;
+        }
+
+        RedoLogDumpHeader header;
+        if (!inputStream.read((char*)&header, sizeof(RedoLogDumpHeader)) || header.magic != DUMP_MAGIC ||
+                header.formatVersion != DUMP_FORMAT_VERSION) {
+            WARNING("invalid log dump file: " << path << ". Skipping log dump.");
+            return REDO_ERROR;
+        }
+
+        oracleAnalyser->version = header.version;
+        oracleAnalyser->isBigEndian = header.bigEndian;
+        sequence = header.sequence;
+
+        string name = path.substr(0, path.length() - 4);
+        oracleAnalyser->dumpStream.open(name);
+        if (!oracleAnalyser->dumpStream.is_open()) {
+            WARNING("can't open " << name << " for write. Skipping log dump.");
+            return REDO_ERROR;
+        }
+        INFO("rendering log dump: " << path << " to: " << name);
+        oracleAnalyser->dumpStream << "DUMP OF REDO FROM FILE '" << path << "'" << endl;
+
+        uint64_t ret = REDO_FINISHED;
+        RedoLogDumpEntry entry;
+        dumpRender = true;
+        while (inputStream.read((char*)&entry, sizeof(RedoLogDumpEntry))) {
+            if (entry.length > REDO_RECORD_MAX_SIZE || entry.size < sizeof(RedoLogDumpEntry) + entry.length) {
+                WARNING("invalid entry in log dump file: " << path << ", length: " << dec << entry.length);
+                ret = REDO_ERROR;
+                break;
+            }
+
+            if (!inputStream.read((char*)recordBuffer, entry.length)) {
+                WARNING("truncated log dump file: " << path);
+                ret = REDO_ERROR;
+                break;
+            }
+            inputStream.seekg(entry.size - sizeof(RedoLogDumpEntry) - entry.length, ios::cur);
+
+            curRecordBlock = entry.block;
+            curRecordPos = entry.pos;
+            curRecordLength = entry.length;
+            try {
+                analyzeRecord();
+            } catch(RedoLogException &ex) {
+                WARNING("forced to continue rendering log dump in spite of error");
+            }
+        }
+        dumpRender = false;
+
+        oracleAnalyser->dumpStream.close();
+        return ret;
+    }
+
+    uint64_t OracleAnalyserRedoLog::replayLog(OracleAnalyserWorker *catchUpWorker) {
+        uint64_t curRet = REDO_ERROR;
+        bool finished = false;
+        CatchUpChunk chunk;
+        struct timespec timeStart, timeEnd;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timeStart);
+
+        while (!finished && !oracleAnalyser->shutdown) {
+            if (!catchUpWorker->getChunk(chunk))
+                break;
+
+            uint64_t pos = 0;
+            while (pos < chunk.size) {
+                CatchUpEntry *entry = (CatchUpEntry*)(chunk.data + pos);
+                pos += entry->size;
+
+                if (entry->type == CATCHUP_FLUSH) {
+                    flushTransactions(entry->scn);
+
+                } else if (entry->type == CATCHUP_RECORD) {
+                    curScn = entry->scn;
+                    recordTimestmap = entry->value;
+                    uint8_t *data = ((uint8_t*)entry) + sizeof(CatchUpEntry);
+
+                    try {
+                        for (uint64_t i = 0; i < entry->items; ++i) {
+                            RedoLogRecord *redoLogRecord[2];
+                            uint64_t count = *((uint64_t*)data);
+                            data += sizeof(uint64_t);
+
+                            for (uint64_t j = 0; j < count; ++j) {
+                                redoLogRecord[j] = (RedoLogRecord*)data;
+                                data += sizeof(RedoLogRecord);
+                                redoLogRecord[j]->data = data;
+                                data += (redoLogRecord[j]->length + 7) & 0xFFFFFFFFFFFFFFF8;
+                            }
+
+                            if (count == 1)
+                                appendToTransaction(redoLogRecord[0]);
+                            else
+                                appendToTransaction(redoLogRecord[0], redoLogRecord[1]);
+                        }
+                    } catch(RedoLogException &ex) {
+                        if ((oracleAnalyser->flags & REDO_FLAGS_ON_ERROR_CONTINUE) == 0) {
+                            RUNTIME_FAIL("runtime error, aborting further redo log processing");
+                        } else
+                            WARNING("forced to continue working in spite of error");
+                    }
+
+                } else if (entry->type == CATCHUP_END) {
+                    curScn = entry->scn;
+                    curRet = entry->value;
+                    finished = true;
+                }
+            }
+
+            catchUpWorker->freeChunk(chunk);
+            oracleAnalyser->checkForCheckpoint();
+        }
+
+        if (curRet == REDO_FINISHED && curScn != ZERO_SCN) {
+            Transaction *transaction;
+            for (uint64_t i = 1; i <= oracleAnalyser->transactionHeap->size; ++i) {
+                transaction = oracleAnalyser->transactionHeap->at(i);
+                transaction->flushSplitBlocks();
+            }
+
+            flushTransactions(curScn);
+        }
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &timeEnd);
+        double myTime = ((timeEnd.tv_sec - timeStart.tv_sec) * 1000000000 + timeEnd.tv_nsec - timeStart.tv_nsec) / 1000000.0;
+        TRACE(TRACE2_PERFORMANCE, "redo replay time: " << myTime << " ms, Sequence: " << dec << sequence);
 
         return curRet;
     }
@@ -17,6 +17,12 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <pthread.h>
+#include <queue>
+
 #include "types.h"
 #include "RedoLogRecord.h"
 
@@ -26,12 +32,47 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 using namespace std;
 
 #define VECTOR_MAX_LENGTH 512
+#define OPCODE_SIZE_MAX   64
+#define FIELD_OFFSETS_RECORD_MAX 16384
+#define INDEX_MAGIC       0x58444E494F444552
+#define INDEX_INTERVAL    1048576
+#define ASSEMBLY_CHUNKS_MAX 4
 
 namespace OpenLogReplicator {
 
     class OracleAnalyser;
+    class OracleAnalyserWorker;
     class OpCode;
     class Reader;
+    class RedoLogDump;
+
+    struct RedoLogIndexHeader {
+        uint64_t magic;
+        uint64_t sequence;
+        typescn firstScn;
+        uint64_t blockSize;
+    };
+
+    //maxScn is the highest SCN of all records before the position
+    struct RedoLogIndexEntry {
+        uint64_t block;
+        uint64_t pos;
+        typescn maxScn;
+    };
+
+    struct AssemblyChunk {
+        uint8_t *data;
+        uint64_t size;
+        uint64_t allocated;                 //0 for memory chunk, otherwise size of oversized buffer
+    };
+
+    //each entry is followed by record data
+    struct AssemblyEntry {
+        uint64_t size;
+        uint64_t length;
+        typeblk block;
+        uint64_t pos;
+    };
 
     class OracleAnalyserRedoLog {
     protected:
@@ -47,17 +88,60 @@ namespace OpenLogReplicator {
         uint64_t recordPos;
         uint64_t recordLength4;
         uint64_t recordLeftToCopy;
+        typeblk curRecordBlock;
+        uint64_t curRecordPos;
+        uint64_t curRecordLength;
         uint64_t blockNumber;
-        OpCode *opCodes[VECTOR_MAX_LENGTH];
+        uint64_t blockPosStart;
+        ofstream indexStream;
+        typeblk indexNextBlock;
+        typescn indexMaxScn;
+        uint64_t vectorsProcessed;
+        uint64_t vectorsSkipped;
+        uint64_t suppLogSize;
         RedoLogRecord zero;
         uint64_t vectors;
+        bool assemblyThreaded;
+        pthread_t assemblyThread;
+        mutex assemblyMtx;
+        condition_variable assemblerCond;
+        condition_variable consumerCond;
+        queue<AssemblyChunk> assemblyChunks;
+        AssemblyChunk assemblyChunk;
+        uint8_t *assemblyBuffer;
+        volatile bool assemblyStop;
+        bool assemblyFinished;
+        bool assemblyFailed;
+        uint64_t assemblyRet;
+        uint64_t assemblyPushes;
+        uint64_t assemblyQueued;
+        uint64_t assemblyQueuedMax;
+        uint64_t assemblerWaits;
+        uint64_t consumerWaits;
+        RedoLogDump *redoLogDump;
+        bool dumpRender;
 
         void printHeaderInfo(void);
         void analyzeRecord(void);
+        void processRecord(void);
         void flushTransactions(typescn checkpointScn);
         void appendToTransaction(RedoLogRecord *redoLogRecord);
         void appendToTransaction(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
         void dumpRedoVector(void);
+        void indexOpen(void);
+        void indexRecord(void);
+        static void *assembleStatic(void *context);
+        void assemble(void);
+        uint64_t assembleLog(void);
+        uint8_t *assemblyReserve(uint64_t size);
+        void assemblyPush(void);
+        bool assemblyGet(AssemblyChunk &chunk);
+        void assemblyFree(AssemblyChunk &chunk);
+        void assemblyStart(void);
+        void assemblyEnd(void);
+        uint64_t analyzeAssembled(void);
+        void dumpOpen(void);
+        void dumpClose(void);
 
     public:
         int64_t group;
@@ -66,10 +150,15 @@ namespace OpenLogReplicator {
         typescn firstScn;
         typescn nextScn;
         Reader *reader;
+        OracleAnalyserWorker *worker;
+        uint8_t *recordBuffer;
 
         void resetRedo(void);
         void continueRedo(OracleAnalyserRedoLog *prev);
+        bool seek(typescn scn);
         uint64_t processLog(void);
+        uint64_t replayLog(OracleAnalyserWorker *catchUpWorker);
+        uint64_t renderDump(void);
         OracleAnalyserRedoLog(OracleAnalyser *oracleAnalyser, int64_t group, const char *path);
         virtual ~OracleAnalyserRedoLog(void);
 
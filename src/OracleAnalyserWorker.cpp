@@ -0,0 +1,243 @@
+/* Thread decoding archived redo log in parallel to analyser
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <thread>
+
+#include "OracleAnalyser.h"
+#include "OracleAnalyserRedoLog.h"
+#include "OracleAnalyserWorker.h"
+#include "Reader.h"
+#include "RedoLogException.h"
+#include "RedoLogRecord.h"
+#include "RuntimeException.h"
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    OracleAnalyserWorker::OracleAnalyserWorker(const char *alias, OracleAnalyser *oracleAnalyser, Reader *reader) :
+        Thread(alias),
+        oracleAnalyser(oracleAnalyser),
+        entry(nullptr),
+        reader(reader),
+        redo(nullptr) {
+
+        chunk.data = nullptr;
+        chunk.size = 0;
+        chunk.allocated = 0;
+    }
+
+    OracleAnalyserWorker::~OracleAnalyserWorker() {
+        if (chunk.data != nullptr)
+            freeChunk(chunk);
+
+        while (!chunks.empty()) {
+            CatchUpChunk chunkTmp = chunks.front();
+            chunks.pop();
+            freeChunk(chunkTmp);
+        }
+    }
+
+    uint8_t *OracleAnalyserWorker::reserve(uint64_t size) {
+        uint64_t capacity = (chunk.allocated > 0) ? chunk.allocated : MEMORY_CHUNK_SIZE;
+        if (chunk.data != nullptr && chunk.size + size > capacity)
+            pushChunk();
+
+        if (chunk.data == nullptr) {
+            //record which does not fit in memory chunk
+            if (size > MEMORY_CHUNK_SIZE) {
+                chunk.data = new uint8_t[size];
+                if (chunk.data == nullptr) {
+                    RUNTIME_FAIL("could not allocate " << dec << size << " bytes memory for (reason: catch-up buffer)");
+                }
+                chunk.allocated = size;
+            } else {
+                chunk.data = oracleAnalyser->getMemoryChunk("CATCHUP", false);
+                chunk.allocated = 0;
+            }
+            chunk.size = 0;
+        }
+
+        return chunk.data + chunk.size;
+    }
+
+    void OracleAnalyserWorker::pushChunk(void) {
+        {
+            unique_lock<mutex> lck(mtx);
+            while (chunks.size() >= CATCHUP_CHUNKS_MAX && !shutdown)
+                workerCond.wait(lck);
+
+            chunks.push(chunk);
+            analyserCond.notify_all();
+        }
+
+        chunk.data = nullptr;
+        chunk.size = 0;
+        chunk.allocated = 0;
+    }
+
+    void *OracleAnalyserWorker::run(void) {
+        TRACE(TRACE2_THREADS, "WORKER (" << hex << this_thread::get_id() << ") START");
+
+        while (!shutdown) {
+            OracleAnalyserRedoLog *redoDecode = nullptr;
+
+            try {
+                {
+                    unique_lock<mutex> lck(mtx);
+                    if (redo == nullptr && !shutdown)
+                        workerCond.wait(lck);
+                    if (redo == nullptr)
+                        continue;
+
+                    redoDecode = new OracleAnalyserRedoLog(oracleAnalyser, 0, redo->path.c_str());
+                    if (redoDecode == nullptr) {
+                        RUNTIME_FAIL("could not allocate " << dec << sizeof(OracleAnalyserRedoLog) << " bytes memory for (reason: catch-up)");
+                    }
+                    redoDecode->sequence = redo->sequence;
+                    redoDecode->firstScn = redo->firstScn;
+                    redoDecode->nextScn = redo->nextScn;
+                    redo = nullptr;
+                }
+
+                redoDecode->reader = reader;
+                redoDecode->worker = this;
+                redoDecode->recordBuffer = recordBuffer;
+                reader->pathMapped = redoDecode->path;
+
+                if (!oracleAnalyser->readerCheckRedoLog(reader)) {
+                    ERROR("opening archive log: " << redoDecode->path);
+                    addEnd(ZERO_SCN, REDO_ERROR);
+                } else if (!oracleAnalyser->readerUpdateRedoLog(reader)) {
+                    ERROR("reading archive log: " << redoDecode->path);
+                    addEnd(ZERO_SCN, REDO_ERROR);
+                } else {
+                    redoDecode->resetRedo();
+                    redoDecode->processLog();
+                }
+            } catch(RedoLogException &ex) {
+                addEnd(ZERO_SCN, REDO_ERROR);
+            } catch(RuntimeException &ex) {
+                addEnd(ZERO_SCN, REDO_ERROR);
+            }
+
+            if (redoDecode != nullptr) {
+                delete redoDecode;
+                redoDecode = nullptr;
+            }
+        }
+
+        TRACE(TRACE2_THREADS, "WORKER (" << hex << this_thread::get_id() << ") STOP");
+        return 0;
+    }
+
+    void OracleAnalyserWorker::assign(OracleAnalyserRedoLog *redo) {
+        unique_lock<mutex> lck(mtx);
+        this->redo = redo;
+        workerCond.notify_all();
+    }
+
+    bool OracleAnalyserWorker::getChunk(CatchUpChunk &chunkTmp) {
+        unique_lock<mutex> lck(mtx);
+        while (chunks.empty()) {
+            if (shutdown)
+                return false;
+            analyserCond.wait(lck);
+        }
+
+        chunkTmp = chunks.front();
+        chunks.pop();
+        workerCond.notify_all();
+        return true;
+    }
+
+    void OracleAnalyserWorker::freeChunk(CatchUpChunk &chunkTmp) {
+        if (chunkTmp.allocated > 0)
+            delete[] chunkTmp.data;
+        else
+            oracleAnalyser->freeMemoryChunk("CATCHUP", chunkTmp.data, false);
+        chunkTmp.data = nullptr;
+    }
+
+    void OracleAnalyserWorker::addFlush(typescn checkpointScn) {
+        CatchUpEntry *entryTmp = (CatchUpEntry*)reserve(sizeof(CatchUpEntry));
+        entryTmp->type = CATCHUP_FLUSH;
+        entryTmp->size = sizeof(CatchUpEntry);
+        entryTmp->scn = checkpointScn;
+        entryTmp->value = 0;
+        entryTmp->items = 0;
+        chunk.size += sizeof(CatchUpEntry);
+    }
+
+    void OracleAnalyserWorker::addEnd(typescn scn, uint64_t ret) {
+        CatchUpEntry *entryTmp = (CatchUpEntry*)reserve(sizeof(CatchUpEntry));
+        entryTmp->type = CATCHUP_END;
+        entryTmp->size = sizeof(CatchUpEntry);
+        entryTmp->scn = scn;
+        entryTmp->value = ret;
+        entryTmp->items = 0;
+        chunk.size += sizeof(CatchUpEntry);
+        pushChunk();
+    }
+
+    void OracleAnalyserWorker::beginRecord(typescn scn, typetime timestamp, uint64_t maxSize) {
+        entry = (CatchUpEntry*)reserve(maxSize);
+        entry->type = CATCHUP_RECORD;
+        entry->size = sizeof(CatchUpEntry);
+        entry->scn = scn;
+        entry->value = timestamp.getVal();
+        entry->items = 0;
+    }
+
+    void OracleAnalyserWorker::addItem(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
+        RedoLogRecord *redoLogRecord[2] = {redoLogRecord1, redoLogRecord2};
+        uint64_t count = (redoLogRecord2 != nullptr) ? 2 : 1;
+        uint8_t *data = ((uint8_t*)entry) + entry->size;
+
+        *((uint64_t*)data) = count;
+        data += sizeof(uint64_t);
+        for (uint64_t i = 0; i < count; ++i) {
+            memcpy(data, redoLogRecord[i], sizeof(RedoLogRecord));
+            ((RedoLogRecord*)data)->fieldOffsetsCnt = 0;
+            data += sizeof(RedoLogRecord);
+            memcpy(data, redoLogRecord[i]->data, redoLogRecord[i]->length);
+            data += (redoLogRecord[i]->length + 7) & 0xFFFFFFFFFFFFFFF8;
+        }
+
+        entry->size = data - (uint8_t*)entry;
+        ++entry->items;
+    }
+
+    void OracleAnalyserWorker::commitRecord(void) {
+        //records which don't touch any transaction are not passed to analyser
+        if (entry->items > 0)
+            chunk.size += entry->size;
+        entry = nullptr;
+    }
+
+    void OracleAnalyserWorker::stop(void) {
+        shutdown = true;
+        {
+            unique_lock<mutex> lck(mtx);
+            workerCond.notify_all();
+            analyserCond.notify_all();
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/* Header for OracleAnalyserWorker class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <stdint.h>
+
+#include "types.h"
+#include "Thread.h"
+
+#ifndef ORACLEANALYSERWORKER_H_
+#define ORACLEANALYSERWORKER_H_
+
+#define CATCHUP_RECORD          1
+#define CATCHUP_FLUSH           2
+#define CATCHUP_END             3
+
+#define CATCHUP_CHUNKS_MAX      4
+#define CATCHUP_THREADS_MAX     64
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    class OracleAnalyser;
+    class OracleAnalyserRedoLog;
+    class Reader;
+    class RedoLogRecord;
+
+    struct CatchUpChunk {
+        uint8_t *data;
+        uint64_t size;
+        uint64_t allocated;                 //0 for memory chunk, otherwise size of oversized buffer
+    };
+
+    //each entry is followed by items: count of records, then records with data
+    struct CatchUpEntry {
+        uint64_t type;
+        uint64_t size;
+        typescn scn;
+        uint64_t value;                     //timestamp for record, return code for end
+        uint64_t items;
+    };
+
+    class OracleAnalyserWorker : public Thread {
+    protected:
+        OracleAnalyser *oracleAnalyser;
+        mutex mtx;
+        condition_variable workerCond;
+        condition_variable analyserCond;
+        queue<CatchUpChunk> chunks;
+        CatchUpChunk chunk;
+        CatchUpEntry *entry;
+
+        uint8_t *reserve(uint64_t size);
+        void pushChunk(void);
+        void *run(void);
+
+    public:
+        uint8_t recordBuffer[REDO_RECORD_MAX_SIZE];
+        Reader *reader;
+        OracleAnalyserRedoLog *redo;
+
+        OracleAnalyserWorker(const char *alias, OracleAnalyser *oracleAnalyser, Reader *reader);
+        virtual ~OracleAnalyserWorker();
+
+        void assign(OracleAnalyserRedoLog *redo);
+        bool getChunk(CatchUpChunk &chunkTmp);
+        void freeChunk(CatchUpChunk &chunkTmp);
+        void addFlush(typescn checkpointScn);
+        void addEnd(typescn scn, uint64_t ret);
+        void beginRecord(typescn scn, typetime timestamp, uint64_t maxSize);
+        void addItem(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
+        void commitRecord(void);
+        virtual void stop(void);
+    };
+}
+
+#endif
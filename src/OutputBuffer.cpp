@@ -48,7 +48,7 @@ namespace OpenLogReplicator {
     const char OutputBuffer::map16[17] = "0123456789abcdef";
 
     OutputBuffer::OutputBuffer(uint64_t messageFormat, uint64_t xidFormat, uint64_t timestampFormat, uint64_t charFormat, uint64_t scnFormat,
-            uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat) :
+            uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat, uint64_t fragmentMb) :
             oracleAnalyser(nullptr),
             messageFormat(messageFormat),
             xidFormat(xidFormat),
@@ -63,9 +63,11 @@ namespace OpenLogReplicator {
             lastTime(0),
             lastScn(0),
             lastXid(0),
+            fragmentNo(0),
             defaultCharacterMapId(0),
             defaultCharacterNcharMapId(0),
             writer(nullptr),
+            fragmentMb(fragmentMb),
             buffersAllocated(0),
             firstBufferPos(0),
             firstBuffer(nullptr),
@@ -1346,8 +1348,7 @@ namespace OpenLogReplicator {
         uint16_t fieldLength = 0, colLength = 0;
         OracleObject *object = redoLogRecord2->object;
 
-        for (uint64_t i = fieldNum; i < redoLogRecord2->rowData; ++i)
-            oracleAnalyser->nextField(redoLogRecord2, fieldNum, fieldPos, fieldLength);
+        oracleAnalyser->skipToField(redoLogRecord2, redoLogRecord2->rowData, fieldNum, fieldPos, fieldLength);
 
         fieldPosStart = fieldPos;
 
@@ -1405,8 +1406,7 @@ namespace OpenLogReplicator {
         uint16_t fieldLength = 0, colLength = 0;
         OracleObject *object = redoLogRecord1->object;
 
-        for (uint64_t i = fieldNum; i < redoLogRecord1->rowData; ++i)
-            oracleAnalyser->nextField(redoLogRecord1, fieldNum, fieldPos, fieldLength);
+        oracleAnalyser->skipToField(redoLogRecord1, redoLogRecord1->rowData, fieldNum, fieldPos, fieldLength);
 
         fieldPosStart = fieldPos;
 
@@ -1533,8 +1533,7 @@ namespace OpenLogReplicator {
                     colNums = nullptr;
                 }
 
-                for (uint64_t i = fieldNum; i < redoLogRecord1p->rowData - 1; ++i)
-                    oracleAnalyser->nextField(redoLogRecord1p, fieldNum, fieldPos, fieldLength);
+                oracleAnalyser->skipToField(redoLogRecord1p, redoLogRecord1p->rowData - 1, fieldNum, fieldPos, fieldLength);
 
                 for (uint64_t i = 0; i < redoLogRecord1p->cc; ++i) {
                     if (fieldNum + 1 > redoLogRecord1p->fieldCnt) {
@@ -1576,8 +1575,7 @@ namespace OpenLogReplicator {
 
             //supplemental columns
             if (redoLogRecord1p->suppLogRowData > 0) {
-                for (uint64_t i = fieldNum; i < redoLogRecord1p->suppLogRowData - 1; ++i)
-                    oracleAnalyser->nextField(redoLogRecord1p, fieldNum, fieldPos, fieldLength);
+                oracleAnalyser->skipToField(redoLogRecord1p, redoLogRecord1p->suppLogRowData - 1, fieldNum, fieldPos, fieldLength);
 
                 colNums = redoLogRecord1p->data + redoLogRecord1p->suppLogNumsDelta;
                 uint8_t* colSizes = redoLogRecord1p->data + redoLogRecord1p->suppLogLenDelta;
@@ -1636,8 +1634,7 @@ namespace OpenLogReplicator {
                     colShift = redoLogRecord2p->suppLogAfter - 1;
                 }
 
-                for (uint64_t i = fieldNum; i < redoLogRecord2p->rowData - 1; ++i)
-                    oracleAnalyser->nextField(redoLogRecord2p, fieldNum, fieldPos, fieldLength);
+                oracleAnalyser->skipToField(redoLogRecord2p, redoLogRecord2p->rowData - 1, fieldNum, fieldPos, fieldLength);
 
                 for (uint64_t i = 0; i < redoLogRecord2p->cc; ++i) {
                     if (fieldNum + 1 > redoLogRecord2p->fieldCnt) {
@@ -70,6 +70,7 @@ namespace OpenLogReplicator {
         typetime lastTime;
         typescn lastScn;
         typexid lastXid;
+        uint64_t fragmentNo;
         uint8_t *afterPos[MAX_NO_COLUMNS];
         uint8_t *beforePos[MAX_NO_COLUMNS];
         uint16_t afterLen[MAX_NO_COLUMNS];
@@ -104,6 +105,7 @@ namespace OpenLogReplicator {
         uint64_t defaultCharacterNcharMapId;
         unordered_map<uint64_t, CharacterSet*> characterMap;
         Writer *writer;
+        uint64_t fragmentMb;        //0 - whole transaction in one message, otherwise size of fragment
         mutex mtx;
         condition_variable writersCond;
 
@@ -116,7 +118,7 @@ namespace OpenLogReplicator {
         uint64_t lastBufferPos;
 
         OutputBuffer(uint64_t messageFormat, uint64_t xidFormat, uint64_t timestampFormat, uint64_t charFormat, uint64_t scnFormat,
-                uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat);
+                uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat, uint64_t fragmentMb);
         virtual ~OutputBuffer();
 
         void initialize(OracleAnalyser *oracleAnalyser);
@@ -126,6 +128,7 @@ namespace OpenLogReplicator {
 
         virtual void processBegin(typescn scn, typetime time, typexid xid) = 0;
         virtual void processCommit(void) = 0;
+        virtual void processFragment(void) = 0;
         virtual void processInsert(OracleObject *object, typedba bdba, typeslot slot, typexid xid) = 0;
         virtual void processUpdate(OracleObject *object, typedba bdba, typeslot slot, typexid xid) = 0;
         virtual void processDelete(OracleObject *object, typedba bdba, typeslot slot, typexid xid) = 0;
@@ -29,8 +29,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
 
     OutputBufferJson::OutputBufferJson(uint64_t messageFormat, uint64_t xidFormat, uint64_t timestampFormat, uint64_t charFormat, uint64_t scnFormat,
-            uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat) :
-            OutputBuffer(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat),
+            uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat, uint64_t fragmentMb) :
+            OutputBuffer(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat, fragmentMb),
             hasPreviousRedo(false),
             hasPreviousColumn(false) {
     }
@@ -491,6 +491,7 @@ namespace OpenLogReplicator {
         lastTime = time;
         lastScn = scn;
         lastXid = xid;
+        fragmentNo = 0;
         hasPreviousRedo = false;
 
         outputBufferBegin();
@@ -506,9 +507,14 @@ namespace OpenLogReplicator {
     }
 
     void OutputBufferJson::processCommit(void) {
-        if (messageFormat == MESSAGE_FORMAT_FULL)
-            outputBufferAppend("]}");
-        else {
+        if (messageFormat == MESSAGE_FORMAT_FULL) {
+            if (fragmentMb > 0) {
+                outputBufferAppend("],\"fragment\":");
+                appendDec(fragmentNo);
+                outputBufferAppend(",\"last\":true}");
+            } else
+                outputBufferAppend("]}");
+        } else {
             outputBufferBegin();
             outputBufferAppend('{');
             appendHeader(false);
@@ -517,6 +523,23 @@ namespace OpenLogReplicator {
         outputBufferCommit();
     }
 
+    void OutputBufferJson::processFragment(void) {
+        if (messageFormat != MESSAGE_FORMAT_FULL)
+            return;
+
+        outputBufferAppend("],\"fragment\":");
+        appendDec(fragmentNo);
+        outputBufferAppend(",\"last\":false}");
+        outputBufferCommit();
+
+        ++fragmentNo;
+        hasPreviousRedo = false;
+        outputBufferBegin();
+        outputBufferAppend('{');
+        appendHeader(true);
+        outputBufferAppend(",\"payload\":[");
+    }
+
     void OutputBufferJson::processInsert(OracleObject *object, typedba bdba, typeslot slot, typexid xid) {
         if (messageFormat == MESSAGE_FORMAT_FULL) {
             if (hasPreviousRedo)
@@ -49,11 +49,12 @@ namespace OpenLogReplicator {
         time_t tmToEpoch(struct tm *epoch);
     public:
         OutputBufferJson(uint64_t messageFormat, uint64_t xidFormat, uint64_t timestampFormat, uint64_t charFormat, uint64_t scnFormat,
-                uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat);
+                uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat, uint64_t fragmentMb);
         virtual ~OutputBufferJson();
 
         virtual void processBegin(typescn scn, typetime time, typexid xid);
         virtual void processCommit(void);
+        virtual void processFragment(void);
         virtual void processInsert(OracleObject *object, typedba bdba, typeslot slot, typexid xid);
         virtual void processUpdate(OracleObject *object, typedba bdba, typeslot slot, typexid xid);
         virtual void processDelete(OracleObject *object, typedba bdba, typeslot slot, typexid xid);
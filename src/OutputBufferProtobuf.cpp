@@ -28,8 +28,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
 
     OutputBufferProtobuf::OutputBufferProtobuf(uint64_t messageFormat, uint64_t xidFormat, uint64_t timestampFormat, uint64_t charFormat, uint64_t scnFormat,
-            uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat) :
-            OutputBuffer(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat)
+            uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat, uint64_t fragmentMb) :
+            OutputBuffer(messageFormat, xidFormat, timestampFormat, charFormat, scnFormat, unknownFormat, schemaFormat, columnFormat, fragmentMb)
 #ifdef LINK_LIBRARY_PROTOBUF
             ,redoPB(nullptr),
             valuePB(nullptr),
@@ -315,6 +315,7 @@ namespace OpenLogReplicator {
         lastTime = time;
         lastScn = scn;
         lastXid = xid;
+        fragmentNo = 0;
         outputBufferBegin();
 
         if (redoPB != nullptr) {
@@ -348,6 +349,10 @@ namespace OpenLogReplicator {
             if (redoPB == nullptr) {
                 RUNTIME_FAIL("ERROR, PB commit processing failed, message missing, internal error");
             }
+            if (fragmentMb > 0) {
+                redoPB->set_fragment(fragmentNo);
+                redoPB->set_last(true);
+            }
         } else {
             if (redoPB != nullptr) {
                 RUNTIME_FAIL("ERROR, PB commit processing failed, message already exists, internal error");
@@ -373,6 +378,35 @@ namespace OpenLogReplicator {
 #endif /* LINK_LIBRARY_PROTOBUF */
     }
 
+    void OutputBufferProtobuf::processFragment(void) {
+#ifdef LINK_LIBRARY_PROTOBUF
+        if (messageFormat != MESSAGE_FORMAT_FULL)
+            return;
+
+        if (redoPB == nullptr) {
+            RUNTIME_FAIL("ERROR, PB fragment processing failed, message missing, internal error");
+        }
+        redoPB->set_fragment(fragmentNo);
+        redoPB->set_last(false);
+
+        string output;
+        bool ret = redoPB->SerializeToString(&output);
+        delete redoPB;
+        redoPB = nullptr;
+
+        if (!ret) {
+            RUNTIME_FAIL("ERROR, PB fragment processing failed, error serializing to string");
+        }
+        outputBufferAppend(output);
+        outputBufferCommit();
+
+        ++fragmentNo;
+        outputBufferBegin();
+        redoPB = new pb::Redo;
+        appendHeader(true);
+#endif /* LINK_LIBRARY_PROTOBUF */
+    }
+
     void OutputBufferProtobuf::processInsert(OracleObject *object, typedba bdba, typeslot slot, typexid xid) {
 #ifdef LINK_LIBRARY_PROTOBUF
         if (messageFormat == MESSAGE_FORMAT_FULL) {
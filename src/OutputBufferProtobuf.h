@@ -51,11 +51,12 @@ protected:
         void numToString(uint64_t value, char *buf, uint64_t length);
 public:
         OutputBufferProtobuf(uint64_t messageFormat, uint64_t xidFormat, uint64_t timestampFormat, uint64_t charFormat, uint64_t scnFormat,
-                uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat);
+                uint64_t unknownFormat, uint64_t schemaFormat, uint64_t columnFormat, uint64_t fragmentMb);
         virtual ~OutputBufferProtobuf();
 
         virtual void processBegin(typescn scn, typetime time, typexid xid);
         virtual void processCommit(void);
+        virtual void processFragment(void);
         virtual void processInsert(OracleObject *object, typedba bdba, typeslot slot, typexid xid);
         virtual void processUpdate(OracleObject *object, typedba bdba, typeslot slot, typexid xid);
         virtual void processDelete(OracleObject *object, typedba bdba, typeslot slot, typexid xid);
@@ -17,8 +17,13 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <string.h>
 #include <thread>
 #include <unistd.h>
+#include <sys/mman.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #include "OracleAnalyser.h"
 #include "Reader.h"
@@ -32,8 +37,12 @@ namespace OpenLogReplicator {
         Thread(alias),
         oracleAnalyser(oracleAnalyser),
         singleBlockRead(singleBlockRead),
+        notify(oracleAnalyser),
         redoBuffer(nullptr),
+        bufferSize(DISK_BUFFER_SIZE),
+        redoMap(nullptr),
         headerBuffer(new uint8_t[REDO_PAGE_SIZE_MAX * 2]),
+        verifyBuffer(new uint8_t[REDO_PAGE_SIZE_MAX]),
         group(group),
         sequence(0),
         blockSize(0),
@@ -46,18 +55,47 @@ namespace OpenLogReplicator {
         firstScnHeader(0),
         nextScnHeader(ZERO_SCN),
         fileSize(0),
+        sumRead(0),
+        sumTime(0),
         status(READER_STATUS_SLEEPING),
+        prefetch(false),
         bufferStart(0),
-        bufferEnd(0) {
+        bufferEnd(0),
+        readerWaiting(false),
+        analyserWaiting(false),
+        readerWaits(0),
+        analyserWaits(0) {
         redoBuffer = oracleAnalyser->getMemoryChunk("DISK", false);
+
+        xorBlock = xorBlockScalar;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            xorBlock = xorBlockAvx512;
+        else if (__builtin_cpu_supports("avx2"))
+            xorBlock = xorBlockAvx2;
+        else if (__builtin_cpu_supports("sse2"))
+            xorBlock = xorBlockSse2;
+#endif
+        if (xorBlock != xorBlockScalar && !xorBlockCheck(xorBlock)) {
+            WARNING("vector checksum kernel gives different results than scalar code, using scalar code");
+            xorBlock = xorBlockScalar;
+        }
         if (headerBuffer == nullptr) {
             RUNTIME_FAIL("could not allocate " << dec << (REDO_PAGE_SIZE_MAX * 2) << " bytes memory for (reason: read buffer)");
         }
+        if (verifyBuffer == nullptr) {
+            RUNTIME_FAIL("could not allocate " << dec << REDO_PAGE_SIZE_MAX << " bytes memory for (reason: verify buffer)");
+        }
     }
 
     Reader::~Reader() {
         if (redoBuffer != nullptr) {
-            oracleAnalyser->freeMemoryChunk("DISK", redoBuffer, false);
+            if (bufferSize != DISK_BUFFER_SIZE) {
+                munmap(redoBuffer, bufferSize);
+                oracleAnalyser->releaseMemoryChunks("DISK", bufferSize / MEMORY_CHUNK_SIZE);
+            } else
+                oracleAnalyser->freeMemoryChunk("DISK", redoBuffer, false);
             redoBuffer = nullptr;
         }
 
@@ -65,9 +103,39 @@ namespace OpenLogReplicator {
             delete[] headerBuffer;
             headerBuffer = nullptr;
         }
+
+        if (verifyBuffer != nullptr) {
+            delete[] verifyBuffer;
+            verifyBuffer = nullptr;
+        }
     }
 
-    uint64_t Reader::checkBlockHeader(uint8_t *buffer, typeblk blockNumber, bool checkSum) {
+    //archived redo logs are read sequentially with larger buffer, huge pages are used if available
+    void Reader::bufferAllocate(uint64_t bufferMb) {
+        if (bufferMb <= DISK_BUFFER_SIZE / 1024 / 1024)
+            return;
+
+        oracleAnalyser->freeMemoryChunk("DISK", redoBuffer, false);
+        redoBuffer = nullptr;
+
+        uint64_t newBufferSize = bufferMb * 1024 * 1024;
+        oracleAnalyser->reserveMemoryChunks("DISK", newBufferSize / MEMORY_CHUNK_SIZE);
+        void *buffer = mmap(nullptr, newBufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (buffer == MAP_FAILED) {
+            buffer = mmap(nullptr, newBufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buffer == MAP_FAILED) {
+                oracleAnalyser->releaseMemoryChunks("DISK", newBufferSize / MEMORY_CHUNK_SIZE);
+                RUNTIME_FAIL("could not allocate " << dec << newBufferSize << " bytes memory for (reason: read buffer)");
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(buffer, newBufferSize, MADV_HUGEPAGE);
+#endif
+        }
+        redoBuffer = (uint8_t*)buffer;
+        bufferSize = newBufferSize;
+    }
+
+    uint64_t Reader::checkBlockHeaderNoSum(uint8_t *buffer, typeblk blockNumber) {
         if (buffer[0] == 0 && buffer[1] == 0)
             return REDO_EMPTY;
 
@@ -101,6 +169,14 @@ namespace OpenLogReplicator {
             return REDO_ERROR;
         }
 
+        return REDO_OK;
+    }
+
+    uint64_t Reader::checkBlockHeader(uint8_t *buffer, typeblk blockNumber, bool checkSum) {
+        uint64_t ret = checkBlockHeaderNoSum(buffer, blockNumber);
+        if (ret != REDO_OK)
+            return ret;
+
         if ((oracleAnalyser->flags & REDO_FLAGS_BLOCK_CHECK_SUM) != 0 &&
                 (checkSum || group == 0 || (oracleAnalyser->flags & REDO_FLAGS_DISABLE_READ_VERIFICATION) != 0)) {
             typesum chSum = oracleAnalyser->read16(buffer + 14);
@@ -315,12 +391,103 @@ namespace OpenLogReplicator {
         return ret;
     }
 
-    typesum Reader::calcChSum(uint8_t *buffer, uint64_t size) {
-        typesum oldChSum = oracleAnalyser->read16(buffer + 14);
+    void Reader::redoReadAhead(uint64_t /*pos*/, uint64_t /*size*/, uint64_t /*limit*/) {
+    }
+
+    void Reader::traceSpeed(void) {
+        double mySpeed = 0, myTime = sumTime / 1000000.0;
+        if (sumTime > 0)
+            mySpeed = sumRead / 1024.0 / 1024.0 / myTime * 1000;
+
+        TRACE(TRACE2_PERFORMANCE, "disk read time: " << fixed << setprecision(2) << myTime << " ms, " <<
+                "Speed: " << fixed << setprecision(2) << mySpeed << " MB/s, " <<
+                "Redo log size: " << dec << (sumRead / 1024) << " kB");
+    }
+
+    uint64_t Reader::xorBlockScalar(const uint8_t *buffer, uint64_t size) {
         uint64_t sum = 0;
 
         for (uint64_t i = 0; i < size / 8; ++i, buffer += 8)
             sum ^= *((uint64_t*)buffer);
+        return sum;
+    }
+
+    //compare with scalar code for all block sizes, odd lengths and unaligned starts
+    bool Reader::xorBlockCheck(uint64_t (*xorBlockTest)(const uint8_t *buffer, uint64_t size)) {
+        uint8_t buffer[REDO_PAGE_SIZE_MAX + 128];
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+        for (uint64_t i = 0; i < sizeof(buffer); ++i) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            buffer[i] = (uint8_t)seed;
+        }
+
+        for (uint64_t size = 0; size <= 200; ++size)
+            for (uint64_t start = 0; start < 64; start += 7)
+                if (xorBlockTest(buffer + start, size) != xorBlockScalar(buffer + start, size))
+                    return false;
+
+        for (uint64_t size = 512; size <= REDO_PAGE_SIZE_MAX; size *= 2)
+            for (uint64_t start = 0; start < 64; start += 7)
+                if (xorBlockTest(buffer + start, size) != xorBlockScalar(buffer + start, size) ||
+                        xorBlockTest(buffer + start, size + 63) != xorBlockScalar(buffer + start, size + 63))
+                    return false;
+
+        return true;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("sse2")))
+    uint64_t Reader::xorBlockSse2(const uint8_t *buffer, uint64_t size) {
+        __m128i sum128 = _mm_setzero_si128();
+        uint64_t i = 0, tmp[2];
+
+        for (; i + 16 <= size; i += 16)
+            sum128 = _mm_xor_si128(sum128, _mm_loadu_si128((const __m128i*)(buffer + i)));
+        _mm_storeu_si128((__m128i*)tmp, sum128);
+
+        return tmp[0] ^ tmp[1] ^ xorBlockScalar(buffer + i, size - i);
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t Reader::xorBlockAvx2(const uint8_t *buffer, uint64_t size) {
+        __m256i sum256 = _mm256_setzero_si256();
+        uint64_t i = 0, tmp[4];
+
+        for (; i + 32 <= size; i += 32)
+            sum256 = _mm256_xor_si256(sum256, _mm256_loadu_si256((const __m256i*)(buffer + i)));
+        _mm256_storeu_si256((__m256i*)tmp, sum256);
+
+        return tmp[0] ^ tmp[1] ^ tmp[2] ^ tmp[3] ^ xorBlockScalar(buffer + i, size - i);
+    }
+
+    __attribute__((target("avx512f")))
+    uint64_t Reader::xorBlockAvx512(const uint8_t *buffer, uint64_t size) {
+        __m512i sum512 = _mm512_setzero_si512();
+        uint64_t i = 0, tmp[8];
+
+        for (; i + 64 <= size; i += 64)
+            sum512 = _mm512_xor_si512(sum512, _mm512_loadu_si512((const void*)(buffer + i)));
+        _mm512_storeu_si512((void*)tmp, sum512);
+
+        return tmp[0] ^ tmp[1] ^ tmp[2] ^ tmp[3] ^ tmp[4] ^ tmp[5] ^ tmp[6] ^ tmp[7] ^ xorBlockScalar(buffer + i, size - i);
+    }
+#endif
+
+    typeblk Reader::checkChSums(uint8_t *buffer, typeblk blocks) {
+        for (typeblk numBlock = 0; numBlock < blocks; ++numBlock, buffer += blockSize) {
+            if (oracleAnalyser->read16(buffer + 14) != calcChSum(buffer, blockSize))
+                return numBlock;
+        }
+        return blocks;
+    }
+
+    typesum Reader::calcChSum(uint8_t *buffer, uint64_t size) {
+        typesum oldChSum = oracleAnalyser->read16(buffer + 14);
+        uint64_t sum = xorBlock(buffer, size);
+
         sum ^= (sum >> 32);
         sum ^= (sum >> 16);
         sum ^= oldChSum;
@@ -328,6 +495,43 @@ namespace OpenLogReplicator {
         return sum & 0xFFFF;
     }
 
+    uint64_t Reader::checkMappedBlocks(uint64_t &curBufferEnd) {
+        uint64_t toCheck = DISK_BUFFER_SIZE / 16;
+        if (curBufferEnd + toCheck > fileSize)
+            toCheck = fileSize - curBufferEnd;
+
+        typeblk maxNumBlock = toCheck / blockSize;
+        typeblk bufferEndBlock = curBufferEnd / blockSize;
+
+        //checksums of whole range at once, block with bad checksum is checked once again to report error
+        typeblk chSumBlocks = maxNumBlock;
+        if ((oracleAnalyser->flags & REDO_FLAGS_BLOCK_CHECK_SUM) != 0)
+            chSumBlocks = checkChSums(redoMap + curBufferEnd, maxNumBlock);
+
+        for (uint64_t numBlock = 0; numBlock < maxNumBlock; ++numBlock) {
+            uint64_t curRet;
+            if (numBlock < chSumBlocks)
+                curRet = checkBlockHeaderNoSum(redoMap + curBufferEnd, bufferEndBlock + numBlock);
+            else
+                curRet = checkBlockHeader(redoMap + curBufferEnd, bufferEndBlock + numBlock, false);
+            TRACE(TRACE2_DISK, "block: " << dec << (bufferEndBlock + numBlock) << " check: " << curRet);
+
+            if (curRet == REDO_EMPTY) {
+                if (nextScnHeader != ZERO_SCN)
+                    return REDO_FINISHED;
+                return REDO_ERROR;
+            } else if (curRet != REDO_OK)
+                return curRet;
+
+            curBufferEnd += blockSize;
+            sumRead += blockSize;
+        }
+
+        if (curBufferEnd + blockSize > fileSize)
+            return REDO_FINISHED;
+        return REDO_OK;
+    }
+
     void *Reader::run(void) {
         uint64_t curStatus;
         TRACE(TRACE2_THREADS, "READER (" << hex << this_thread::get_id() << ") START");
@@ -339,8 +543,14 @@ namespace OpenLogReplicator {
 
                 if (status == READER_STATUS_SLEEPING && !shutdown) {
                     oracleAnalyser->sleepingCond.wait(lck);
-                } else if (status == READER_STATUS_READ && bufferStart + DISK_BUFFER_SIZE == bufferEnd && !shutdown) {
-                    oracleAnalyser->readerCond.wait(lck);
+                } else if (status == READER_STATUS_READ && !shutdown) {
+                    //buffer full, the analyser wakes the reader only when this flag is set
+                    readerWaiting = true;
+                    if (bufferStart + bufferSize == bufferEnd) {
+                        ++readerWaits;
+                        oracleAnalyser->readerCond.wait(lck);
+                    }
+                    readerWaiting = false;
                 }
                 curStatus = status;
             }
@@ -355,7 +565,11 @@ namespace OpenLogReplicator {
                 {
                     unique_lock<mutex> lck(oracleAnalyser->mtx);
                     ret = curRet;
-                    status = READER_STATUS_SLEEPING;
+                    //reading in background, continue with header without waiting for the analyser
+                    if (prefetch && curRet == REDO_OK)
+                        status = READER_STATUS_UPDATE;
+                    else
+                        status = READER_STATUS_SLEEPING;
                     oracleAnalyser->analyserCond.notify_all();
                 }
                 continue;
@@ -365,38 +579,43 @@ namespace OpenLogReplicator {
                 if (curRet == REDO_OK) {
                     bufferStart = blockSize * 2;
                     bufferEnd = blockSize * 2;
+                    sumRead = 0;
+                    sumTime = 0;
+                    readerWaits = 0;
+                    analyserWaits = 0;
                 }
 
                 {
                     unique_lock<mutex> lck(oracleAnalyser->mtx);
                     ret = curRet;
-                    status = READER_STATUS_SLEEPING;
+                    //mapped file is verified by the analyser
+                    if (prefetch && curRet == REDO_OK && redoMap == nullptr)
+                        status = READER_STATUS_READ;
+                    else
+                        status = READER_STATUS_SLEEPING;
                     oracleAnalyser->analyserCond.notify_all();
                 }
             } else if (status == READER_STATUS_READ) {
-                uint64_t curBufferStart = 0;
-                {
-                    unique_lock<mutex> lck(oracleAnalyser->mtx);
-                    curBufferStart = bufferStart;
-                }
+                uint64_t curBufferStart = bufferStart;
 
                 TRACE(TRACE2_DISK, "reading " << pathMapped << " at (" << dec << curBufferStart << "/" << bufferEnd << ") at size: " << fileSize);
                 uint64_t lastRead = blockSize;
-                while (!shutdown && status == READER_STATUS_READ && curBufferStart + DISK_BUFFER_SIZE > bufferEnd) {
+                while (!shutdown && status == READER_STATUS_READ && curBufferStart + bufferSize > bufferEnd) {
                     uint64_t toRead = 0;
 
                     if (singleBlockRead) {
                         toRead = blockSize;
                     } else {
                         toRead = lastRead;
-                        if (bufferEnd + toRead - bufferStart > DISK_BUFFER_SIZE)
-                            toRead = DISK_BUFFER_SIZE - bufferEnd + bufferStart;
+                        if (bufferEnd + toRead - bufferStart > bufferSize)
+                            toRead = bufferSize - bufferEnd + bufferStart;
                     }
 
                     if (bufferEnd + toRead > fileSize)
                         toRead = fileSize - bufferEnd;
 
                     if (toRead == 0) {
+                        traceSpeed();
                         unique_lock<mutex> lck(oracleAnalyser->mtx);
                         status = READER_STATUS_SLEEPING;
                         ret = REDO_FINISHED;
@@ -404,12 +623,18 @@ namespace OpenLogReplicator {
                         break;
                     }
 
-                    uint64_t bufferPos = bufferEnd % DISK_BUFFER_SIZE;
-                    if (bufferPos + toRead > DISK_BUFFER_SIZE)
-                        toRead = DISK_BUFFER_SIZE - bufferPos;
+                    uint64_t bufferPos = bufferEnd % bufferSize;
+                    if (bufferPos + toRead > bufferSize)
+                        toRead = bufferSize - bufferPos;
 
                     TRACE(TRACE2_DISK, "reading " << pathMapped << " at (" << dec << bufferStart << "/" << bufferEnd << ")" << " bytes: " << dec << toRead);
+                    struct timespec timeStart, timeEnd;
+                    clock_gettime(CLOCK_MONOTONIC, &timeStart);
                     int64_t actualRead = redoRead(redoBuffer + bufferPos, bufferEnd, toRead);
+                    clock_gettime(CLOCK_MONOTONIC, &timeEnd);
+                    sumTime += (timeEnd.tv_sec - timeStart.tv_sec) * 1000000000 + timeEnd.tv_nsec - timeStart.tv_nsec;
+                    if (actualRead > 0)
+                        sumRead += actualRead;
 
                     TRACE(TRACE2_DISK, "reading " << pathMapped << " at (" << dec << bufferStart << "/" << bufferEnd << ")" << " got: " << dec << actualRead);
                     if (actualRead < 0) {
@@ -420,6 +645,10 @@ namespace OpenLogReplicator {
                         break;
                     }
 
+                    //archived redo log can't change, next reads may be started before this one is verified
+                    if (group == 0 && actualRead > 0)
+                        redoReadAhead(bufferEnd + (actualRead / blockSize) * blockSize, lastRead, curBufferStart + bufferSize);
+
                     typeblk maxNumBlock = actualRead / blockSize;
                     typeblk bufferEndBlock = bufferEnd / blockSize;
                     uint64_t curBufferEnd = bufferEnd;
@@ -427,8 +656,11 @@ namespace OpenLogReplicator {
                     uint64_t goodBlocks = 0, curRet = REDO_OK;
                     bool reachedZero = false;
 
+                    //checksums are verified already in first read when only last block is read once again
+                    bool checkSumFirst = (group != 0 && (oracleAnalyser->flags & REDO_FLAGS_VERIFY_LAST_BLOCK) != 0 &&
+                            (oracleAnalyser->flags & REDO_FLAGS_BLOCK_CHECK_SUM) != 0);
                     for (uint64_t numBlock = 0; numBlock < maxNumBlock; ++numBlock) {
-                        curRet = checkBlockHeader(redoBuffer + bufferPos + numBlock * blockSize, bufferEndBlock + numBlock, false);
+                        curRet = checkBlockHeader(redoBuffer + bufferPos + numBlock * blockSize, bufferEndBlock + numBlock, checkSumFirst);
                         TRACE(TRACE2_DISK, "block: " << dec << (bufferEndBlock + numBlock) << " check: " << curRet);
 
                         if (curRet == REDO_OVERWRITTEN) {
@@ -449,8 +681,29 @@ namespace OpenLogReplicator {
                         ++goodBlocks;
                     }
 
+                    //only last block may be still written, compare it with second read
+                    if (goodBlocks > 0 && checkSumFirst && (oracleAnalyser->flags & REDO_FLAGS_DISABLE_READ_VERIFICATION) == 0) {
+                        uint8_t *lastBlock = redoBuffer + bufferPos + (goodBlocks - 1) * blockSize;
+                        actualRead = redoRead(verifyBuffer, bufferEnd + (goodBlocks - 1) * blockSize, blockSize);
+
+                        TRACE(TRACE2_DISK, "second reading " << pathMapped << " at (" << dec << (bufferEnd + (goodBlocks - 1) * blockSize) << ")" << " got: " << dec << actualRead);
+
+                        if (actualRead < 0) {
+                            unique_lock<mutex> lck(oracleAnalyser->mtx);
+                            status = READER_STATUS_SLEEPING;
+                            ret = REDO_ERROR;
+                            oracleAnalyser->analyserCond.notify_all();
+                            break;
+                        }
+
+                        if (actualRead != (int64_t)blockSize || memcmp(lastBlock, verifyBuffer, blockSize) != 0) {
+                            TRACE(TRACE2_DISK, "block: " << dec << (bufferEndBlock + goodBlocks - 1) << " changed, reading once again");
+                            --goodBlocks;
+                            reachedZero = false;
+                        }
+
                     //read verification to prevent buffer overwrite
-                    if (goodBlocks > 0 && group != 0 && (oracleAnalyser->flags & REDO_FLAGS_DISABLE_READ_VERIFICATION) == 0) {
+                    } else if (goodBlocks > 0 && group != 0 && (oracleAnalyser->flags & REDO_FLAGS_DISABLE_READ_VERIFICATION) == 0) {
                         actualRead = redoRead(redoBuffer + bufferPos, bufferEnd, goodBlocks * blockSize);
                         reachedZero = false;
 
@@ -495,8 +748,8 @@ namespace OpenLogReplicator {
 
                     if (goodBlocks == maxNumBlock) {
                         lastRead = lastRead * 2;
-                        if (lastRead > DISK_BUFFER_SIZE / 8)
-                            lastRead = DISK_BUFFER_SIZE / 8;
+                        if (lastRead > bufferSize / 8)
+                            lastRead = bufferSize / 8;
                     } else if (goodBlocks < maxNumBlock / 4) {
                         lastRead /= 4;
                         if (lastRead < blockSize)
@@ -509,6 +762,7 @@ namespace OpenLogReplicator {
 
                     //reached EOF
                     if ((reachedZero && nextScnHeader != ZERO_SCN) || curBufferEnd == fileSize) {
+                        traceSpeed();
                         unique_lock<mutex> lck(oracleAnalyser->mtx);
                         bufferEnd = curBufferEnd;
                         status = READER_STATUS_SLEEPING;
@@ -519,13 +773,16 @@ namespace OpenLogReplicator {
 
                     //some data has been read, try to process it first
                     if (curBufferEnd > bufferEnd) {
-                        unique_lock<mutex> lck(oracleAnalyser->mtx);
                         bufferEnd = curBufferEnd;
                         curBufferStart = bufferStart;
-                        oracleAnalyser->analyserCond.notify_all();
+                        if (analyserWaiting) {
+                            unique_lock<mutex> lck(oracleAnalyser->mtx);
+                            oracleAnalyser->analyserCond.notify_all();
+                        }
+                        notify.reset();
                     } else {
-                        //nothing new read, check if header has changed
-                        usleep(oracleAnalyser->redoReadSleep);
+                        //nothing new read, wait for next write and check if header has changed
+                        notify.wait(oracleAnalyser->redoReadSleep);
                         curRet = reloadHeader();
                     }
 
@@ -17,6 +17,7 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <string>
@@ -24,6 +25,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <pthread.h>
 
 #include "types.h"
+#include "FileNotify.h"
 #include "Thread.h"
 
 #ifndef READER_H_
@@ -49,6 +51,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define REDO_EMPTY              4
 
 #define DISK_BUFFER_SIZE        MEMORY_CHUNK_SIZE
+#define DISK_BUFFER_MAX_MB      1024
 #define REDO_PAGE_SIZE_MAX      4096
 
 using namespace std;
@@ -61,17 +64,25 @@ namespace OpenLogReplicator {
     protected:
         OracleAnalyser *oracleAnalyser;
         bool singleBlockRead;
+        FileNotify notify;
 
         virtual void redoClose(void) = 0;
         virtual uint64_t redoOpen(void) = 0;
         virtual int64_t redoRead(uint8_t *buf, uint64_t pos, uint64_t size) = 0;
+        virtual void redoReadAhead(uint64_t pos, uint64_t size, uint64_t limit);
 
+        uint64_t checkBlockHeaderNoSum(uint8_t *buffer, typeblk blockNumber);
         uint64_t checkBlockHeader(uint8_t *buffer, typeblk blockNumber, bool checkSum);
+        typeblk checkChSums(uint8_t *buffer, typeblk blocks);
         uint64_t reloadHeader(void);
+        void traceSpeed(void);
 
     public:
         uint8_t *redoBuffer;
+        uint64_t bufferSize;
+        uint8_t *redoMap;
         uint8_t *headerBuffer;
+        uint8_t *verifyBuffer;
         int64_t group;
         typeseq sequence;
         vector<string> paths;
@@ -87,16 +98,36 @@ namespace OpenLogReplicator {
         typescn nextScnHeader;
 
         uint64_t fileSize;
+        uint64_t sumRead;
+        uint64_t sumTime;
         volatile uint64_t status;
+        bool prefetch;
         volatile uint64_t ret;
-        volatile uint64_t bufferStart;
-        volatile uint64_t bufferEnd;
+        atomic<uint64_t> bufferStart;
+        atomic<uint64_t> bufferEnd;
+        atomic<bool> readerWaiting;
+        atomic<bool> analyserWaiting;
+        uint64_t readerWaits;
+        uint64_t analyserWaits;
 
         Reader(const char *alias, OracleAnalyser *oracleAnalyser, int64_t group, bool singleBlockRead);
         virtual ~Reader();
 
+        void bufferAllocate(uint64_t bufferMb);
+
         void *run(void);
+        uint64_t (*xorBlock)(const uint8_t *buffer, uint64_t size);
+
+        static uint64_t xorBlockScalar(const uint8_t *buffer, uint64_t size);
+        static bool xorBlockCheck(uint64_t (*xorBlockTest)(const uint8_t *buffer, uint64_t size));
+#if defined(__x86_64__) || defined(__i386__)
+        static uint64_t xorBlockSse2(const uint8_t *buffer, uint64_t size);
+        static uint64_t xorBlockAvx2(const uint8_t *buffer, uint64_t size);
+        static uint64_t xorBlockAvx512(const uint8_t *buffer, uint64_t size);
+#endif
+
         typesum calcChSum(uint8_t *buffer, uint64_t size);
+        uint64_t checkMappedBlocks(uint64_t &curBufferEnd);
     };
 }
 
@@ -0,0 +1,378 @@
+/* Class for reading compressed archived redo logs
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <string.h>
+#include <thread>
+
+#include "OracleAnalyser.h"
+#include "ReaderCompressed.h"
+#include "RuntimeException.h"
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    ReaderCompressed::ReaderCompressed(const char *alias, OracleAnalyser *oracleAnalyser, uint64_t group) :
+        ReaderFilesystem(alias, oracleAnalyser, group),
+        compression(COMPRESSION_NONE),
+        inputBuffer(nullptr),
+        inputPos(0),
+        inputOffset(0),
+        inputLength(0),
+        inputEnd(false),
+        streamEnd(false),
+        outputBuffer(nullptr),
+        outputStart(0),
+        outputEnd(0),
+        outputFinished(false),
+        outputError(false),
+        decompressStarted(false),
+        decompressStop(false),
+        decompressThread(0)
+#ifdef LINK_LIBRARY_ZLIB
+        ,zStreamInitialized(false)
+#endif /* LINK_LIBRARY_ZLIB */
+#ifdef LINK_LIBRARY_ZSTD
+        ,zstdStream(nullptr)
+#endif /* LINK_LIBRARY_ZSTD */
+    {
+    }
+
+    ReaderCompressed::~ReaderCompressed() {
+        redoClose();
+
+        if (inputBuffer != nullptr) {
+            delete[] inputBuffer;
+            inputBuffer = nullptr;
+        }
+
+        if (outputBuffer != nullptr) {
+            delete[] outputBuffer;
+            outputBuffer = nullptr;
+        }
+    }
+
+    void *ReaderCompressed::decompressStatic(void *context) {
+        ((ReaderCompressed *) context)->decompress();
+        return 0;
+    }
+
+    void ReaderCompressed::decompress(void) {
+        TRACE(TRACE2_THREADS, "DECOMPRESS (" << hex << this_thread::get_id() << ") START");
+        bool finished = false, error = false;
+
+        while (!finished && !error) {
+            uint64_t writePos, writeSize;
+            {
+                unique_lock<mutex> lck(decompressMtx);
+                while (outputEnd - outputStart == DECOMPRESS_BUFFER_SIZE && !decompressStop)
+                    producerCond.wait(lck);
+                if (decompressStop)
+                    break;
+
+                writePos = outputEnd % DECOMPRESS_BUFFER_SIZE;
+                writeSize = DECOMPRESS_BUFFER_SIZE - (outputEnd - outputStart);
+                if (writePos + writeSize > DECOMPRESS_BUFFER_SIZE)
+                    writeSize = DECOMPRESS_BUFFER_SIZE - writePos;
+            }
+
+            if (inputOffset == inputLength && !inputEnd) {
+                int64_t bytes = ReaderFilesystem::redoRead(inputBuffer, inputPos, DECOMPRESS_INPUT_SIZE);
+                if (bytes < 0) {
+                    ERROR("unable to read file " << pathMapped << ", errno = " << dec << errno);
+                    error = true;
+                } else {
+                    if (bytes == 0)
+                        inputEnd = true;
+                    inputPos += bytes;
+                    inputOffset = 0;
+                    inputLength = bytes;
+                }
+            }
+
+            int64_t produced = 0;
+            if (!error) {
+                if (inputOffset == inputLength && inputEnd) {
+                    if (streamEnd)
+                        finished = true;
+                    else {
+                        ERROR("compressed file " << pathMapped << " is truncated");
+                        error = true;
+                    }
+                } else {
+                    produced = decompressStep(outputBuffer + writePos, writeSize);
+                    if (produced < 0)
+                        error = true;
+                }
+            }
+
+            {
+                unique_lock<mutex> lck(decompressMtx);
+                if (produced > 0)
+                    outputEnd += produced;
+                outputFinished = finished;
+                outputError = error;
+                consumerCond.notify_all();
+            }
+        }
+
+        TRACE(TRACE2_THREADS, "DECOMPRESS (" << hex << this_thread::get_id() << ") STOP");
+    }
+
+    bool ReaderCompressed::decompressInit(void) {
+        if (compression == COMPRESSION_GZIP) {
+#ifdef LINK_LIBRARY_ZLIB
+            memset(&zStream, 0, sizeof(zStream));
+            //expect gzip header
+            if (inflateInit2(&zStream, 16 + MAX_WBITS) != Z_OK) {
+                ERROR("unable to initialize gzip decompression for " << pathMapped);
+                return false;
+            }
+            zStreamInitialized = true;
+            return true;
+#else
+            ERROR("gzip compressed redo log is not supported, recompile with --with-zlib: " << pathMapped);
+            return false;
+#endif /* LINK_LIBRARY_ZLIB */
+        } else if (compression == COMPRESSION_ZSTD) {
+#ifdef LINK_LIBRARY_ZSTD
+            zstdStream = ZSTD_createDStream();
+            if (zstdStream == nullptr) {
+                ERROR("unable to initialize zstd decompression for " << pathMapped);
+                return false;
+            }
+            ZSTD_initDStream(zstdStream);
+            return true;
+#else
+            ERROR("zstd compressed redo log is not supported, recompile with --with-zstd: " << pathMapped);
+            return false;
+#endif /* LINK_LIBRARY_ZSTD */
+        }
+
+        return false;
+    }
+
+    void ReaderCompressed::decompressEnd(void) {
+#ifdef LINK_LIBRARY_ZLIB
+        if (zStreamInitialized) {
+            inflateEnd(&zStream);
+            zStreamInitialized = false;
+        }
+#endif /* LINK_LIBRARY_ZLIB */
+#ifdef LINK_LIBRARY_ZSTD
+        if (zstdStream != nullptr) {
+            ZSTD_freeDStream(zstdStream);
+            zstdStream = nullptr;
+        }
+#endif /* LINK_LIBRARY_ZSTD */
+    }
+
+#if defined(LINK_LIBRARY_ZLIB) || defined(LINK_LIBRARY_ZSTD)
+    int64_t ReaderCompressed::decompressStep(uint8_t *buffer, uint64_t size) {
+        int64_t produced = 0;
+
+        if (compression == COMPRESSION_GZIP) {
+#ifdef LINK_LIBRARY_ZLIB
+            zStream.next_in = inputBuffer + inputOffset;
+            zStream.avail_in = inputLength - inputOffset;
+            zStream.next_out = buffer;
+            zStream.avail_out = size;
+
+            int ret = inflate(&zStream, Z_NO_FLUSH);
+            inputOffset = inputLength - zStream.avail_in;
+            produced = size - zStream.avail_out;
+
+            if (ret == Z_STREAM_END) {
+                //gzip file may consist of many members
+                streamEnd = true;
+                inflateReset(&zStream);
+            } else if (ret == Z_OK || ret == Z_BUF_ERROR) {
+                streamEnd = false;
+            } else {
+                ERROR("gzip decompression of " << pathMapped << " failed, error: " << dec << ret);
+                return -1;
+            }
+#endif /* LINK_LIBRARY_ZLIB */
+        } else if (compression == COMPRESSION_ZSTD) {
+#ifdef LINK_LIBRARY_ZSTD
+            ZSTD_inBuffer input = {inputBuffer + inputOffset, inputLength - inputOffset, 0};
+            ZSTD_outBuffer output = {buffer, size, 0};
+
+            size_t ret = ZSTD_decompressStream(zstdStream, &output, &input);
+            if (ZSTD_isError(ret)) {
+                ERROR("zstd decompression of " << pathMapped << " failed, error: " << ZSTD_getErrorName(ret));
+                return -1;
+            }
+            inputOffset += input.pos;
+            produced = output.pos;
+            //0 is returned when a frame is completely decoded
+            streamEnd = (ret == 0);
+#endif /* LINK_LIBRARY_ZSTD */
+        }
+
+        return produced;
+    }
+#else
+    int64_t ReaderCompressed::decompressStep(uint8_t */*buffer*/, uint64_t /*size*/) {
+        return 0;
+    }
+#endif /* LINK_LIBRARY_ZLIB || LINK_LIBRARY_ZSTD */
+
+    bool ReaderCompressed::decompressStart(void) {
+        if (inputBuffer == nullptr) {
+            inputBuffer = new uint8_t[DECOMPRESS_INPUT_SIZE];
+            if (inputBuffer == nullptr) {
+                RUNTIME_FAIL("could not allocate " << dec << DECOMPRESS_INPUT_SIZE << " bytes memory for (reason: decompression input buffer)");
+            }
+        }
+
+        if (outputBuffer == nullptr) {
+            outputBuffer = new uint8_t[DECOMPRESS_BUFFER_SIZE];
+            if (outputBuffer == nullptr) {
+                RUNTIME_FAIL("could not allocate " << dec << DECOMPRESS_BUFFER_SIZE << " bytes memory for (reason: decompression output buffer)");
+            }
+        }
+
+        inputPos = 0;
+        inputOffset = 0;
+        inputLength = 0;
+        inputEnd = false;
+        streamEnd = false;
+        outputStart = 0;
+        outputEnd = 0;
+        outputFinished = false;
+        outputError = false;
+        decompressStop = false;
+
+        if (!decompressInit())
+            return false;
+
+        if (pthread_create(&decompressThread, nullptr, &ReaderCompressed::decompressStatic, (void*)this)) {
+            ERROR("spawning decompression thread for " << pathMapped);
+            decompressEnd();
+            return false;
+        }
+        decompressStarted = true;
+
+        return true;
+    }
+
+    void ReaderCompressed::decompressFinish(void) {
+        if (decompressStarted) {
+            {
+                unique_lock<mutex> lck(decompressMtx);
+                decompressStop = true;
+                producerCond.notify_all();
+            }
+            pthread_join(decompressThread, nullptr);
+            decompressStarted = false;
+        }
+        decompressEnd();
+    }
+
+    void ReaderCompressed::redoClose(void) {
+        decompressFinish();
+        ReaderFilesystem::redoClose();
+    }
+
+    uint64_t ReaderCompressed::redoOpen(void) {
+        uint64_t ret = ReaderFilesystem::redoOpen();
+        if (ret != REDO_OK)
+            return ret;
+
+        compression = COMPRESSION_NONE;
+        uint64_t length = pathMapped.length();
+        if (length > 3 && pathMapped.compare(length - 3, 3, ".gz") == 0)
+            compression = COMPRESSION_GZIP;
+        else if (length > 4 && pathMapped.compare(length - 4, 4, ".zst") == 0)
+            compression = COMPRESSION_ZSTD;
+
+        if (compression == COMPRESSION_NONE)
+            return REDO_OK;
+
+        //size of decompressed data is known after whole file is read
+        fileSize = DECOMPRESS_SIZE_UNKNOWN;
+        if (!decompressStart())
+            return REDO_ERROR;
+
+        return REDO_OK;
+    }
+
+    int64_t ReaderCompressed::redoRead(uint8_t *buf, uint64_t pos, uint64_t size) {
+        if (compression == COMPRESSION_NONE)
+            return ReaderFilesystem::redoRead(buf, pos, size);
+
+        //data before this position has been already dropped, decompress from the beginning
+        bool restart;
+        {
+            unique_lock<mutex> lck(decompressMtx);
+            restart = (pos < outputStart);
+        }
+        if (restart) {
+            TRACE(TRACE2_FILE, "restarting decompression of " << pathMapped << " to read position " << dec << pos);
+            decompressFinish();
+            if (!decompressStart())
+                return -1;
+        }
+
+        uint64_t minSize = size;
+        if (minSize > DECOMPRESS_BUFFER_SIZE / 2)
+            minSize = DECOMPRESS_BUFFER_SIZE / 2;
+
+        int64_t bytes = 0;
+        {
+            unique_lock<mutex> lck(decompressMtx);
+            while (true) {
+                //data before read position is not needed any more
+                if (pos > outputStart) {
+                    outputStart = (pos < outputEnd) ? pos : outputEnd;
+                    producerCond.notify_all();
+                }
+
+                if (outputError)
+                    return -1;
+                if (pos + minSize <= outputEnd || outputFinished)
+                    break;
+                consumerCond.wait(lck);
+            }
+
+            if (outputFinished)
+                fileSize = outputEnd;
+
+            if (pos < outputEnd) {
+                bytes = outputEnd - pos;
+                if ((uint64_t)bytes > size)
+                    bytes = size;
+
+                uint64_t readPos = pos % DECOMPRESS_BUFFER_SIZE;
+                uint64_t firstSize = bytes;
+                if (readPos + firstSize > DECOMPRESS_BUFFER_SIZE)
+                    firstSize = DECOMPRESS_BUFFER_SIZE - readPos;
+
+                memcpy(buf, outputBuffer + readPos, firstSize);
+                if ((uint64_t)bytes > firstSize)
+                    memcpy(buf + firstSize, outputBuffer, bytes - firstSize);
+            }
+        }
+
+        TRACE(TRACE2_FILE, "read (decompressed) " << pathMapped << ", " << dec << pos << ", " << dec << size << " returns " << dec << bytes);
+        return bytes;
+    }
+}
@@ -0,0 +1,99 @@
+/* Header for ReaderCompressed class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <condition_variable>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+
+#include "types.h"
+#include "ReaderFilesystem.h"
+
+#ifdef LINK_LIBRARY_ZLIB
+#include <zlib.h>
+#endif /* LINK_LIBRARY_ZLIB */
+
+#ifdef LINK_LIBRARY_ZSTD
+#include <zstd.h>
+#endif /* LINK_LIBRARY_ZSTD */
+
+#ifndef READERCOMPRESSED_H_
+#define READERCOMPRESSED_H_
+
+#define COMPRESSION_NONE        0
+#define COMPRESSION_GZIP        1
+#define COMPRESSION_ZSTD        2
+
+#define DECOMPRESS_INPUT_SIZE   MEMORY_CHUNK_SIZE
+#define DECOMPRESS_BUFFER_SIZE  (MEMORY_CHUNK_SIZE * 4)
+#define DECOMPRESS_SIZE_UNKNOWN 0xFFFFFFFFFFFFFFFF
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    class OracleAnalyser;
+
+    class ReaderCompressed : public ReaderFilesystem {
+    protected:
+        uint64_t compression;
+        uint8_t *inputBuffer;
+        uint64_t inputPos;
+        uint64_t inputOffset;
+        uint64_t inputLength;
+        bool inputEnd;
+        bool streamEnd;
+        uint8_t *outputBuffer;
+        uint64_t outputStart;
+        uint64_t outputEnd;
+        bool outputFinished;
+        bool outputError;
+        bool decompressStarted;
+        volatile bool decompressStop;
+        pthread_t decompressThread;
+        mutex decompressMtx;
+        condition_variable producerCond;
+        condition_variable consumerCond;
+#ifdef LINK_LIBRARY_ZLIB
+        z_stream zStream;
+        bool zStreamInitialized;
+#endif /* LINK_LIBRARY_ZLIB */
+#ifdef LINK_LIBRARY_ZSTD
+        ZSTD_DStream *zstdStream;
+#endif /* LINK_LIBRARY_ZSTD */
+
+        static void *decompressStatic(void *context);
+        void decompress(void);
+        bool decompressInit(void);
+        void decompressEnd(void);
+        int64_t decompressStep(uint8_t *buffer, uint64_t size);
+        bool decompressStart(void);
+        void decompressFinish(void);
+
+        virtual void redoClose(void);
+        virtual uint64_t redoOpen(void);
+        virtual int64_t redoRead(uint8_t *buf, uint64_t pos, uint64_t size);
+
+    public:
+        ReaderCompressed(const char *alias, OracleAnalyser *oracleAnalyser, uint64_t group);
+        virtual ~ReaderCompressed();
+    };
+}
+
+#endif
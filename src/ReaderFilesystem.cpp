@@ -77,6 +77,10 @@ namespace OpenLogReplicator {
             FULL("file system does not support direct read for: " << pathMapped);
         }
 
+        //online redo log is tailed, wake up on writes
+        if (group != 0)
+            notify.addWatch(pathMapped, NOTIFY_MASK_FILE);
+
         return REDO_OK;
     }
 
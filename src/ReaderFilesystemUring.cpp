@@ -0,0 +1,191 @@
+/* Class for reading redo from file system using io_uring
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+
+#include "OracleAnalyser.h"
+#include "ReaderFilesystemUring.h"
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    ReaderFilesystemUring::ReaderFilesystemUring(const char *alias, OracleAnalyser *oracleAnalyser, uint64_t group, uint64_t queueDepth) :
+        ReaderCompressed(alias, oracleAnalyser, group),
+        queueDepth(queueDepth)
+#ifdef LINK_LIBRARY_LIBURING
+        ,ringInitialized(false),
+        requestsFirst(0),
+        requestsCount(0)
+#endif /* LINK_LIBRARY_LIBURING */
+    {
+
+        if (this->queueDepth > URING_QUEUE_DEPTH_MAX)
+            this->queueDepth = URING_QUEUE_DEPTH_MAX;
+
+#ifdef LINK_LIBRARY_LIBURING
+        int ret = io_uring_queue_init(this->queueDepth, &ring, 0);
+        if (ret < 0) {
+            WARNING("io_uring is not available (error: " << dec << -ret << "), using synchronous reads");
+        } else
+            ringInitialized = true;
+#endif /* LINK_LIBRARY_LIBURING */
+    }
+
+    ReaderFilesystemUring::~ReaderFilesystemUring() {
+#ifdef LINK_LIBRARY_LIBURING
+        if (ringInitialized) {
+            dropRequests();
+            io_uring_queue_exit(&ring);
+            ringInitialized = false;
+        }
+#endif /* LINK_LIBRARY_LIBURING */
+    }
+
+#ifdef LINK_LIBRARY_LIBURING
+    void ReaderFilesystemUring::waitForRequest(void) {
+        struct io_uring_cqe *cqe = nullptr;
+        int ret;
+
+        io_uring_submit(&ring);
+        do {
+            ret = io_uring_wait_cqe(&ring, &cqe);
+        } while (ret == -EINTR);
+
+        if (ret < 0) {
+            //ring is not usable any more, mark all requests as failed
+            WARNING("io_uring wait failed (error: " << dec << -ret << "), using synchronous reads");
+            for (uint64_t i = 0; i < requestsCount; ++i) {
+                UringRequest *request = requests + (requestsFirst + i) % queueDepth;
+                if (!request->done) {
+                    request->bytes = -1;
+                    request->done = true;
+                }
+            }
+            return;
+        }
+
+        UringRequest *request = (UringRequest*)io_uring_cqe_get_data(cqe);
+        request->bytes = cqe->res;
+        request->done = true;
+        io_uring_cqe_seen(&ring, cqe);
+    }
+
+    void ReaderFilesystemUring::dropRequests(void) {
+        for (uint64_t i = 0; i < requestsCount; ++i) {
+            UringRequest *request = requests + (requestsFirst + i) % queueDepth;
+            while (!request->done)
+                waitForRequest();
+        }
+        requestsFirst = 0;
+        requestsCount = 0;
+    }
+#endif /* LINK_LIBRARY_LIBURING */
+
+    void ReaderFilesystemUring::redoClose(void) {
+#ifdef LINK_LIBRARY_LIBURING
+        //kernel may not write to the buffer after the file is closed
+        dropRequests();
+#endif /* LINK_LIBRARY_LIBURING */
+        ReaderCompressed::redoClose();
+    }
+
+    int64_t ReaderFilesystemUring::redoRead(uint8_t *buf, uint64_t pos, uint64_t size) {
+#ifdef LINK_LIBRARY_LIBURING
+        if (requestsCount > 0) {
+            UringRequest *request = requests + requestsFirst;
+
+            //the read has been already started, the result may be shorter than requested
+            if (request->pos == pos && request->size <= size) {
+                while (!request->done)
+                    waitForRequest();
+
+                int64_t bytes = request->bytes;
+                TRACE(TRACE2_FILE, "read (uring) " << pathMapped << ", " << dec << pos << ", " << dec << request->size << " returns " << dec << bytes);
+                requestsFirst = (requestsFirst + 1) % queueDepth;
+                --requestsCount;
+
+                if (bytes >= 0)
+                    return bytes;
+            }
+
+            //not expected read position or error, drop everything and read synchronously
+            dropRequests();
+        }
+#endif /* LINK_LIBRARY_LIBURING */
+
+        return ReaderCompressed::redoRead(buf, pos, size);
+    }
+
+#ifdef LINK_LIBRARY_LIBURING
+    void ReaderFilesystemUring::redoReadAhead(uint64_t pos, uint64_t size, uint64_t limit) {
+        if (!ringInitialized || size == 0 || compression != COMPRESSION_NONE)
+            return;
+
+        //continue after reads which are already queued
+        if (requestsCount > 0) {
+            UringRequest *request = requests + (requestsFirst + requestsCount - 1) % queueDepth;
+            if (request->pos + request->size > pos)
+                pos = request->pos + request->size;
+        }
+
+        uint64_t queued = 0;
+        while (requestsCount < queueDepth && pos < fileSize && pos < limit) {
+            uint64_t toRead = size;
+            if (pos + toRead > fileSize)
+                toRead = fileSize - pos;
+            if (pos + toRead > limit)
+                toRead = limit - pos;
+
+            uint64_t bufferPos = pos % bufferSize;
+            if (bufferPos + toRead > bufferSize)
+                toRead = bufferSize - bufferPos;
+
+            struct io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+            if (sqe == nullptr)
+                break;
+
+            UringRequest *request = requests + (requestsFirst + requestsCount) % queueDepth;
+            request->pos = pos;
+            request->size = toRead;
+            request->bytes = 0;
+            request->done = false;
+
+            io_uring_prep_read(sqe, fileDes, redoBuffer + bufferPos, toRead, pos);
+            io_uring_sqe_set_data(sqe, request);
+            TRACE(TRACE2_FILE, "queue read (uring) " << pathMapped << ", " << dec << pos << ", " << dec << toRead);
+
+            ++requestsCount;
+            ++queued;
+            pos += toRead;
+        }
+
+        if (queued > 0) {
+            int ret = io_uring_submit(&ring);
+            if (ret < 0) {
+                //requests are still in the submission queue, they would be retried by next wait
+                TRACE(TRACE2_FILE, "io_uring submit " << pathMapped << " returns " << dec << ret);
+            }
+        }
+    }
+#else
+    void ReaderFilesystemUring::redoReadAhead(uint64_t /*pos*/, uint64_t /*size*/, uint64_t /*limit*/) {
+    }
+#endif /* LINK_LIBRARY_LIBURING */
+}
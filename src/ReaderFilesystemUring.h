@@ -0,0 +1,72 @@
+/* Header for ReaderFilesystemUring class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <string>
+
+#include "types.h"
+#include "ReaderCompressed.h"
+
+#ifdef LINK_LIBRARY_LIBURING
+#include <liburing.h>
+#endif /* LINK_LIBRARY_LIBURING */
+
+#ifndef READERFILESYSTEMURING_H_
+#define READERFILESYSTEMURING_H_
+
+#define URING_QUEUE_DEPTH_MAX   64
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    class OracleAnalyser;
+
+    struct UringRequest {
+        uint64_t pos;
+        uint64_t size;
+        int64_t bytes;
+        bool done;
+    };
+
+    class ReaderFilesystemUring : public ReaderCompressed {
+    protected:
+        uint64_t queueDepth;
+#ifdef LINK_LIBRARY_LIBURING
+        struct io_uring ring;
+        bool ringInitialized;
+        UringRequest requests[URING_QUEUE_DEPTH_MAX];
+        uint64_t requestsFirst;
+        uint64_t requestsCount;
+
+        void waitForRequest(void);
+        void dropRequests(void);
+#endif /* LINK_LIBRARY_LIBURING */
+
+        virtual void redoClose(void);
+        virtual int64_t redoRead(uint8_t *buf, uint64_t pos, uint64_t size);
+        virtual void redoReadAhead(uint64_t pos, uint64_t size, uint64_t limit);
+
+    public:
+        ReaderFilesystemUring(const char *alias, OracleAnalyser *oracleAnalyser, uint64_t group, uint64_t queueDepth);
+        virtual ~ReaderFilesystemUring();
+    };
+}
+
+#endif
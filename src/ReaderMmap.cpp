@@ -0,0 +1,68 @@
+/* Class for reading archived redo from memory mapped file
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <sys/mman.h>
+
+#include "OracleAnalyser.h"
+#include "ReaderMmap.h"
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    ReaderMmap::ReaderMmap(const char *alias, OracleAnalyser *oracleAnalyser, uint64_t group) :
+        ReaderCompressed(alias, oracleAnalyser, group) {
+    }
+
+    ReaderMmap::~ReaderMmap() {
+        redoClose();
+    }
+
+    void ReaderMmap::redoClose(void) {
+        if (redoMap != nullptr) {
+            munmap(redoMap, fileSize);
+            redoMap = nullptr;
+        }
+        ReaderCompressed::redoClose();
+    }
+
+    uint64_t ReaderMmap::redoOpen(void) {
+        uint64_t ret = ReaderCompressed::redoOpen();
+        //decompressed data is read using buffer
+        if (ret != REDO_OK || fileSize == 0 || compression != COMPRESSION_NONE)
+            return ret;
+
+        void *addr = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fileDes, 0);
+        TRACE(TRACE2_FILE, "mmap for " << pathMapped << " returns " << (addr != MAP_FAILED ? 0 : -1) << ", errno = " << errno);
+
+        //not possible to map, read the file using buffer
+        if (addr == MAP_FAILED) {
+            FULL("memory mapping not possible for: " << pathMapped);
+            return REDO_OK;
+        }
+
+        if (madvise(addr, fileSize, MADV_SEQUENTIAL) != 0) {
+            TRACE(TRACE2_FILE, "madvise for " << pathMapped << " failed, errno = " << errno);
+        }
+        redoMap = (uint8_t*)addr;
+
+        return REDO_OK;
+    }
+}
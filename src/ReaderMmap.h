@@ -0,0 +1,46 @@
+/* Header for ReaderMmap class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <string>
+
+#include "types.h"
+#include "ReaderCompressed.h"
+
+#ifndef READERMMAP_H_
+#define READERMMAP_H_
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    class OracleAnalyser;
+
+    class ReaderMmap : public ReaderCompressed {
+    protected:
+        virtual void redoClose(void);
+        virtual uint64_t redoOpen(void);
+
+    public:
+        ReaderMmap(const char *alias, OracleAnalyser *oracleAnalyser, uint64_t group);
+        virtual ~ReaderMmap();
+    };
+}
+
+#endif
@@ -0,0 +1,223 @@
+/* Thread writing binary dump of redo log records
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <thread>
+
+#include "OracleAnalyser.h"
+#include "RedoLogDump.h"
+#include "RuntimeException.h"
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    RedoLogDump::RedoLogDump(const char *alias, OracleAnalyser *oracleAnalyser) :
+        Thread(alias),
+        oracleAnalyser(oracleAnalyser),
+        finished(false),
+        failed(false),
+        running(false),
+        bytesWritten(0),
+        producerWaits(0) {
+
+        chunk.data = nullptr;
+        chunk.size = 0;
+        chunk.allocated = 0;
+    }
+
+    RedoLogDump::~RedoLogDump() {
+        //not finished because of error, just stop the thread
+        if (running) {
+            stop();
+            pthread_join(pthread, nullptr);
+            running = false;
+        }
+
+        if (chunk.data != nullptr)
+            freeChunk(chunk);
+
+        while (!chunks.empty()) {
+            freeChunk(chunks.front());
+            chunks.pop();
+        }
+
+        if (dumpStream.is_open())
+            dumpStream.close();
+    }
+
+    bool RedoLogDump::open(string &fileName, typeseq sequence, uint64_t blockSize) {
+        dumpStream.open(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+        if (!dumpStream.is_open())
+            return false;
+        this->fileName = fileName;
+
+        RedoLogDumpHeader header;
+        header.magic = DUMP_MAGIC;
+        header.formatVersion = DUMP_FORMAT_VERSION;
+        header.version = oracleAnalyser->version;
+        header.bigEndian = oracleAnalyser->isBigEndian ? 1 : 0;
+        header.sequence = sequence;
+        header.blockSize = blockSize;
+        dumpStream.write((char*)&header, sizeof(RedoLogDumpHeader));
+        if (dumpStream.fail()) {
+            RUNTIME_FAIL("error writing redo log dump: " << fileName);
+        }
+
+        if (pthread_create(&pthread, nullptr, &Thread::runStatic, (void*)this)) {
+            RUNTIME_FAIL("spawning thread - redo log dump");
+        }
+        running = true;
+        return true;
+    }
+
+    void RedoLogDump::addRecord(uint8_t *data, uint64_t length, typeblk block, uint64_t pos) {
+        uint64_t size = sizeof(RedoLogDumpEntry) + ((length + 7) & 0xFFFFFFFFFFFFFFF8);
+        uint64_t capacity = (chunk.allocated > 0) ? chunk.allocated : MEMORY_CHUNK_SIZE;
+        if (chunk.data != nullptr && chunk.size + size > capacity)
+            pushChunk();
+
+        if (chunk.data == nullptr) {
+            //record which does not fit in memory chunk
+            if (size > MEMORY_CHUNK_SIZE) {
+                chunk.data = new uint8_t[size];
+                if (chunk.data == nullptr) {
+                    RUNTIME_FAIL("could not allocate " << dec << size << " bytes memory for (reason: redo log dump)");
+                }
+                chunk.allocated = size;
+            } else {
+                chunk.data = oracleAnalyser->getMemoryChunk("DUMP", false);
+                chunk.allocated = 0;
+            }
+            chunk.size = 0;
+        }
+
+        RedoLogDumpEntry *entry = (RedoLogDumpEntry*)(chunk.data + chunk.size);
+        entry->size = size;
+        entry->length = length;
+        entry->block = block;
+        entry->pos = pos;
+        memcpy(chunk.data + chunk.size + sizeof(RedoLogDumpEntry), data, length);
+        chunk.size += size;
+    }
+
+    void RedoLogDump::pushChunk(void) {
+        bool failedTmp;
+        {
+            unique_lock<mutex> lck(mtx);
+            while (chunks.size() >= DUMP_CHUNKS_MAX && !failed && !shutdown) {
+                ++producerWaits;
+                analyserCond.wait(lck);
+            }
+
+            failedTmp = failed;
+            if (!failed && !shutdown) {
+                chunks.push(chunk);
+                dumpCond.notify_all();
+                chunk.data = nullptr;
+            }
+        }
+
+        if (chunk.data != nullptr)
+            freeChunk(chunk);
+        chunk.size = 0;
+        chunk.allocated = 0;
+
+        if (failedTmp) {
+            RUNTIME_FAIL("error writing redo log dump: " << fileName);
+        }
+    }
+
+    void RedoLogDump::freeChunk(RedoLogDumpChunk &chunkTmp) {
+        if (chunkTmp.allocated > 0)
+            delete[] chunkTmp.data;
+        else
+            oracleAnalyser->freeMemoryChunk("DUMP", chunkTmp.data, false);
+        chunkTmp.data = nullptr;
+        chunkTmp.size = 0;
+        chunkTmp.allocated = 0;
+    }
+
+    void *RedoLogDump::run(void) {
+        TRACE(TRACE2_THREADS, "DUMP (" << hex << this_thread::get_id() << ") START");
+
+        try {
+            while (true) {
+                RedoLogDumpChunk chunkTmp;
+                {
+                    unique_lock<mutex> lck(mtx);
+                    while (chunks.empty() && !finished && !shutdown)
+                        dumpCond.wait(lck);
+                    //finished is set after the last chunk is pushed
+                    if (chunks.empty() || shutdown)
+                        break;
+
+                    chunkTmp = chunks.front();
+                    chunks.pop();
+                    analyserCond.notify_all();
+                }
+
+                dumpStream.write((char*)chunkTmp.data, chunkTmp.size);
+                bytesWritten += chunkTmp.size;
+                freeChunk(chunkTmp);
+                if (dumpStream.fail()) {
+                    RUNTIME_FAIL("error writing redo log dump: " << fileName);
+                }
+            }
+
+            dumpStream.flush();
+            if (dumpStream.fail()) {
+                RUNTIME_FAIL("error writing redo log dump: " << fileName);
+            }
+        } catch(RuntimeException &ex) {
+            unique_lock<mutex> lck(mtx);
+            failed = true;
+            analyserCond.notify_all();
+        }
+
+        TRACE(TRACE2_THREADS, "DUMP (" << hex << this_thread::get_id() << ") STOP");
+        return 0;
+    }
+
+    void RedoLogDump::finish(void) {
+        if (!running)
+            return;
+
+        if (chunk.data != nullptr && chunk.size > 0 && !shutdown)
+            pushChunk();
+        {
+            unique_lock<mutex> lck(mtx);
+            finished = true;
+            dumpCond.notify_all();
+        }
+        pthread_join(pthread, nullptr);
+        running = false;
+
+        if (failed) {
+            RUNTIME_FAIL("error writing redo log dump: " << fileName);
+        }
+    }
+
+    void RedoLogDump::stop(void) {
+        unique_lock<mutex> lck(mtx);
+        shutdown = true;
+        dumpCond.notify_all();
+        analyserCond.notify_all();
+    }
+}
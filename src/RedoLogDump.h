@@ -0,0 +1,97 @@
+/* Header for RedoLogDump class
+   Copyright (C) 2018-2020 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <stdint.h>
+
+#include "types.h"
+#include "Thread.h"
+
+#ifndef REDOLOGDUMP_H_
+#define REDOLOGDUMP_H_
+
+#define DUMP_MAGIC              0x504D55444F444552
+#define DUMP_FORMAT_VERSION     1
+#define DUMP_CHUNKS_MAX         8
+
+using namespace std;
+
+namespace OpenLogReplicator {
+
+    class OracleAnalyser;
+
+    struct RedoLogDumpHeader {
+        uint64_t magic;
+        uint64_t formatVersion;
+        uint64_t version;
+        uint64_t bigEndian;
+        typeseq sequence;
+        uint64_t blockSize;
+    };
+
+    //each entry is followed by raw record data padded to 8 bytes
+    struct RedoLogDumpEntry {
+        uint64_t size;
+        uint64_t length;
+        typeblk block;
+        uint64_t pos;
+    };
+
+    struct RedoLogDumpChunk {
+        uint8_t *data;
+        uint64_t size;
+        uint64_t allocated;                 //0 for memory chunk, otherwise size of oversized buffer
+    };
+
+    class RedoLogDump : public Thread {
+    protected:
+        OracleAnalyser *oracleAnalyser;
+        ofstream dumpStream;
+        string fileName;
+        mutex mtx;
+        condition_variable dumpCond;
+        condition_variable analyserCond;
+        queue<RedoLogDumpChunk> chunks;
+        RedoLogDumpChunk chunk;
+        bool finished;
+        bool failed;
+        bool running;
+
+        void pushChunk(void);
+        void freeChunk(RedoLogDumpChunk &chunkTmp);
+        void *run(void);
+
+    public:
+        uint64_t bytesWritten;
+        uint64_t producerWaits;
+
+        RedoLogDump(const char *alias, OracleAnalyser *oracleAnalyser);
+        virtual ~RedoLogDump();
+
+        bool open(string &fileName, typeseq sequence, uint64_t blockSize);
+        void addRecord(uint8_t *data, uint64_t length, typeblk block, uint64_t pos);
+        void finish(void);
+        virtual void stop(void);
+    };
+}
+
+#endif
@@ -28,6 +28,9 @@ using namespace std;
 
 namespace OpenLogReplicator {
 
+#define FIELD_OFFSET_MAX        0x3FFFC
+#define FIELD_OFFSETS_SIZE(cnt) ((((uint64_t)(cnt)) * 2 + 7) & 0xFFFFFFFFFFFFFFF8)
+
 #define FLAGS_XA                0x01
 #define FLAGS_XR                0x02
 #define FLAGS_CR                0x03
@@ -112,7 +115,9 @@ namespace OpenLogReplicator {
         typescn scn;              //scn
         typesubscn subScn;        //subscn
         uint8_t *data;            //data
+        uint16_t *fieldOffsets;   //positions of first fields divided by 4, stored outside of the record
         uint16_t fieldCnt;
+        uint16_t fieldOffsetsCnt;
         uint64_t fieldPos;
         uint64_t rowData;
         uint8_t nrow;
@@ -163,6 +168,7 @@ namespace OpenLogReplicator {
         uint64_t suppLogRowData;
         uint64_t suppLogNumsDelta;
         uint64_t suppLogLenDelta;
+        uint64_t suppLogSize;
         uint64_t opFlags;
 
         void dumpHex(ostream &str, OracleAnalyser *oracleAnalyser);
@@ -53,6 +53,9 @@ namespace OpenLogReplicator {
             lastScn(ZERO_SCN),
             firstTc(nullptr),
             lastTc(nullptr),
+            tcInMemory(0),
+            spillFd(-1),
+            spillSize(0),
             opCodes(0),
             pos(0),
             lastRedoLogRecord1(nullptr),
@@ -77,6 +80,55 @@ namespace OpenLogReplicator {
             firstTc = nullptr;
             lastTc = nullptr;
         }
+        oracleAnalyser->transactionBuffer->deleteTransactionSpill(this);
+
+        for (uint64_t i = 0; i < rollbackKeys.size(); ++i) {
+            RollbackIndexEntry entry = oracleAnalyser->rollbackIndex.get(rollbackKeys[i]);
+            //key could have been taken over by another transaction
+            if (entry.xid == xid && entry.pos == i)
+                oracleAnalyser->rollbackIndex.erase(rollbackKeys[i]);
+        }
+        oracleAnalyser->rollbackKeysCnt -= rollbackKeys.size();
+        rollbackKeys.clear();
+        oracleAnalyser->updateRollbackIndexMemory();
+    }
+
+    void Transaction::addRollbackKey(uint64_t key) {
+        RollbackIndexEntry entry = oracleAnalyser->rollbackIndex.get(key);
+        if (entry.xid == xid)
+            return;
+        if (entry.xid != 0) {
+            TRACE(TRACE2_ROLLBACK, "rollback index key taken over from XID: " << PRINTXID(entry.xid) << " by XID: " << PRINTXID(xid));
+        }
+
+        entry.xid = xid;
+        entry.pos = rollbackKeys.size();
+        oracleAnalyser->rollbackIndex.set(key, entry);
+        rollbackKeys.push_back(key);
+        ++oracleAnalyser->rollbackKeysCnt;
+        oracleAnalyser->updateRollbackIndexMemory();
+    }
+
+    void Transaction::removeRollbackKey(uint64_t key) {
+        RollbackIndexEntry entry = oracleAnalyser->rollbackIndex.get(key);
+        if (entry.xid != xid)
+            return;
+
+        //move last key to the freed position
+        uint64_t lastPos = rollbackKeys.size() - 1;
+        uint64_t lastKey = rollbackKeys[lastPos];
+        if (entry.pos != lastPos) {
+            rollbackKeys[entry.pos] = lastKey;
+            RollbackIndexEntry lastEntry = oracleAnalyser->rollbackIndex.get(lastKey);
+            if (lastEntry.xid == xid && lastEntry.pos == lastPos) {
+                lastEntry.pos = entry.pos;
+                oracleAnalyser->rollbackIndex.set(lastKey, lastEntry);
+            }
+        }
+        rollbackKeys.pop_back();
+        --oracleAnalyser->rollbackKeysCnt;
+        oracleAnalyser->rollbackIndex.erase(key);
+        oracleAnalyser->updateRollbackIndexMemory();
     }
 
     void Transaction::mergeSplitBlocksToBuffer(uint8_t *buffer, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
@@ -113,6 +165,7 @@ namespace OpenLogReplicator {
         redoLogRecord1->fieldCnt = fieldCnt;
         redoLogRecord1->fieldPos = fieldPos1;
         redoLogRecord1->data = buffer;
+        redoLogRecord1->fieldOffsetsCnt = 0;
 
         uint16_t myFieldLength = oracleAnalyser->read16(redoLogRecord1->data + redoLogRecord1->fieldLengthsDelta + 1 * 2);
     }
@@ -223,6 +276,7 @@ namespace OpenLogReplicator {
         memcpy(splitBlock + SPLIT_BLOCK_RECORD1, redoLogRecord, sizeof(RedoLogRecord));
         memcpy(splitBlock + SPLIT_BLOCK_DATA1, redoLogRecord->data, redoLogRecord->length);
         ((RedoLogRecord*)(splitBlock + SPLIT_BLOCK_RECORD1))->data = splitBlock + SPLIT_BLOCK_DATA1;
+        ((RedoLogRecord*)(splitBlock + SPLIT_BLOCK_RECORD1))->fieldOffsetsCnt = 0;
 
         tmpSplitBlockList = splitBlockList;
         while (tmpSplitBlockList != nullptr) {
@@ -258,10 +312,12 @@ namespace OpenLogReplicator {
         memcpy(splitBlock + SPLIT_BLOCK_RECORD1, redoLogRecord1, sizeof(RedoLogRecord));
         memcpy(splitBlock + SPLIT_BLOCK_DATA1, redoLogRecord1->data, redoLogRecord1->length);
         ((RedoLogRecord*)(splitBlock + SPLIT_BLOCK_RECORD1))->data = splitBlock + SPLIT_BLOCK_DATA1;
+        ((RedoLogRecord*)(splitBlock + SPLIT_BLOCK_RECORD1))->fieldOffsetsCnt = 0;
 
         memcpy(splitBlock + SPLIT_BLOCK_RECORD2 + redoLogRecord1->length, redoLogRecord2, sizeof(RedoLogRecord));
         memcpy(splitBlock + SPLIT_BLOCK_DATA2 + redoLogRecord1->length, redoLogRecord2->data, redoLogRecord2->length);
         ((RedoLogRecord*)(splitBlock + SPLIT_BLOCK_RECORD2 + redoLogRecord1->length))->data = splitBlock + SPLIT_BLOCK_DATA2 + redoLogRecord1->length;
+        ((RedoLogRecord*)(splitBlock + SPLIT_BLOCK_RECORD2 + redoLogRecord1->length))->fieldOffsetsCnt = 0;
 
         tmpSplitBlockList = splitBlockList;
         while (tmpSplitBlockList != nullptr) {
@@ -285,6 +341,8 @@ namespace OpenLogReplicator {
 
         oracleAnalyser->transactionBuffer->addTransactionChunk(this, redoLogRecord1, redoLogRecord2);
         ++opCodes;
+
+        addRollbackKey(ROLLBACK_KEY(redoLogRecord1->uba, redoLogRecord1->slt));
         touch(scn, sequence);
     }
 
@@ -292,6 +350,7 @@ namespace OpenLogReplicator {
             typescn scn) {
 
         if (oracleAnalyser->transactionBuffer->deleteTransactionPart(this, rollbackRedoLogRecord1, rollbackRedoLogRecord2)) {
+            removeRollbackKey(ROLLBACK_KEY(rollbackRedoLogRecord1->uba, rollbackRedoLogRecord2->slt));
             --opCodes;
             if (lastScn == ZERO_SCN || lastScn < scn)
                 lastScn = scn;
@@ -301,6 +360,8 @@ namespace OpenLogReplicator {
     }
 
     void Transaction::rollbackLastOp(typescn scn) {
+        if (lastRedoLogRecord1 != nullptr)
+            removeRollbackKey(ROLLBACK_KEY(lastRedoLogRecord1->uba, lastRedoLogRecord1->slt));
         oracleAnalyser->transactionBuffer->rollbackTransactionChunk(this);
         --opCodes;
         if (lastScn == ZERO_SCN || lastScn < scn)
@@ -411,7 +472,11 @@ namespace OpenLogReplicator {
             RedoLogRecord *first1 = nullptr, *first2 = nullptr, *last1 = nullptr, *last2 = nullptr;
             typescn prevScn = 0;
 
+            //spilled chunks are read back one by one before the ones in memory
+            uint64_t spillPos = 0;
             TransactionChunk *tc = firstTc;
+            if (spillEntries.size() > 0)
+                tc = oracleAnalyser->transactionBuffer->readSpilledChunk(this, 0);
             while (tc != nullptr) {
                 pos = 0;
                 for (uint64_t i = 0; i < tc->elements; ++i) {
@@ -419,9 +484,13 @@ namespace OpenLogReplicator {
 
                     RedoLogRecord *redoLogRecord1 = ((RedoLogRecord *)(tc->buffer + pos + ROW_HEADER_REDO1)),
                                   *redoLogRecord2 = ((RedoLogRecord *)(tc->buffer + pos + ROW_HEADER_REDO2));
+                    uint64_t dataSize = redoLogRecord1->length + redoLogRecord2->length;
                     redoLogRecord1->data = tc->buffer + pos + ROW_HEADER_DATA;
                     redoLogRecord2->data = tc->buffer + pos + ROW_HEADER_DATA + redoLogRecord1->length;
-                    typescn scn = *((typescn *)(tc->buffer + pos + ROW_HEADER_SCN + redoLogRecord1->length + redoLogRecord2->length));
+                    redoLogRecord1->fieldOffsets = (uint16_t *)(tc->buffer + pos + ROW_HEADER_DATA + dataSize);
+                    redoLogRecord2->fieldOffsets = (uint16_t *)(tc->buffer + pos + ROW_HEADER_DATA + dataSize + FIELD_OFFSETS_SIZE(redoLogRecord1->fieldCnt));
+                    dataSize += ROW_FIELD_OFFSETS(redoLogRecord1, redoLogRecord2);
+                    typescn scn = *((typescn *)(tc->buffer + pos + ROW_HEADER_SCN + dataSize));
 
                     TRACE(TRACE2_TRANSACTION, "Row: " << setfill(' ') << setw(4) << dec << redoLogRecord1->length <<
                                         ":" << setfill(' ') << setw(4) << dec << redoLogRecord2->length <<
@@ -450,7 +519,7 @@ namespace OpenLogReplicator {
                         FULL("SCN swap");
                     }
 
-                    pos += redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL;
+                    pos += dataSize + ROW_HEADER_TOTAL;
 
                     opFlush = false;
                     switch (op) {
@@ -569,6 +638,11 @@ namespace OpenLogReplicator {
                         RUNTIME_FAIL("Unknown OpCode " << hex << op);
                     }
 
+                    //stream very big transactions as a sequence of fragments
+                    if (oracleAnalyser->outputBuffer->fragmentMb > 0 &&
+                            oracleAnalyser->outputBuffer->outputBufferSize() + DATA_BUFFER_SIZE > oracleAnalyser->outputBuffer->fragmentMb * 1024 * 1024) {
+                        oracleAnalyser->outputBuffer->processFragment();
+                    } else
                     //split very big transactions
                     if (oracleAnalyser->outputBuffer->writer->maxMessageMb > 0 &&
                             oracleAnalyser->outputBuffer->outputBufferSize() + DATA_BUFFER_SIZE > oracleAnalyser->outputBuffer->writer->maxMessageMb * 1024 * 1024) {
@@ -594,6 +668,13 @@ namespace OpenLogReplicator {
                 }
 
                 TransactionChunk *nextTc = tc->next;
+                if (spillPos < spillEntries.size()) {
+                    ++spillPos;
+                    if (spillPos < spillEntries.size())
+                        nextTc = oracleAnalyser->transactionBuffer->readSpilledChunk(this, spillPos);
+                    else
+                        nextTc = firstTc;
+                }
                 tc->next = deallocTc;
                 deallocTc = tc;
                 tc = nextTc;
@@ -607,6 +688,8 @@ namespace OpenLogReplicator {
 
             firstTc = nullptr;
             lastTc = nullptr;
+            tcInMemory = 0;
+            oracleAnalyser->transactionBuffer->deleteTransactionSpill(this);
             lastRedoLogRecord1 = nullptr;
             lastRedoLogRecord2 = nullptr;
             opCodes = 0;
@@ -625,6 +708,27 @@ namespace OpenLogReplicator {
         lastRedoLogRecord2 = (RedoLogRecord*)(lastTc->buffer + lastTc->size - lastSize + ROW_HEADER_REDO2);
     }
 
+    //rollback index covers only operations of chunks kept in memory
+    void Transaction::addChunkRollbackKeys(TransactionChunk *tc) {
+        uint64_t pos = tc->size;
+        while (pos > 0) {
+            uint64_t lastSize = *((uint64_t *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SIZE));
+            RedoLogRecord *redoLogRecord1 = (RedoLogRecord*)(tc->buffer + pos - lastSize + ROW_HEADER_REDO1);
+            addRollbackKey(ROLLBACK_KEY(redoLogRecord1->uba, redoLogRecord1->slt));
+            pos -= lastSize;
+        }
+    }
+
+    void Transaction::removeChunkRollbackKeys(TransactionChunk *tc) {
+        uint64_t pos = tc->size;
+        while (pos > 0) {
+            uint64_t lastSize = *((uint64_t *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SIZE));
+            RedoLogRecord *redoLogRecord1 = (RedoLogRecord*)(tc->buffer + pos - lastSize + ROW_HEADER_REDO1);
+            removeRollbackKey(ROLLBACK_KEY(redoLogRecord1->uba, redoLogRecord1->slt));
+            pos -= lastSize;
+        }
+    }
+
     bool Transaction::matchesForRollback(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2,
             RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2) {
 
@@ -17,7 +17,11 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <vector>
+
 #include "types.h"
+#include "RedoLogRecord.h"
+#include "TransactionBuffer.h"
 
 #ifndef TRANSACTION_H_
 #define TRANSACTION_H_
@@ -33,6 +37,9 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define SPLIT_BLOCK_RECORD2    (sizeof(uint8_t*)+sizeof(uint8_t*)+sizeof(typeop1)+sizeof(typeop1)+sizeof(RedoLogRecord))
 #define SPLIT_BLOCK_DATA2      (sizeof(uint8_t*)+sizeof(uint8_t*)+sizeof(typeop1)+sizeof(typeop1)+sizeof(RedoLogRecord)+sizeof(RedoLogRecord))
 
+//uba uses lower 56 bits
+#define ROLLBACK_KEY(uba,slt)  ((uba)|((uint64_t)(slt)<<56))
+
 
 namespace OpenLogReplicator {
 
@@ -50,6 +57,8 @@ namespace OpenLogReplicator {
 
         void mergeSplitBlocksToBuffer(uint8_t *buffer, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
         void mergeSplitBlocks(RedoLogRecord *headRedoLogRecord1, RedoLogRecord *midRedoLogRecord1, RedoLogRecord *tailRedoLogRecord1, RedoLogRecord *redoLogRecord2);
+        void addRollbackKey(uint64_t key);
+        void removeRollbackKey(uint64_t key);
 
     public:
         typexid xid;
@@ -58,6 +67,11 @@ namespace OpenLogReplicator {
         typescn lastScn;
         TransactionChunk *firstTc;
         TransactionChunk *lastTc;
+        uint64_t tcInMemory;
+        int spillFd;
+        uint64_t spillSize;
+        vector<TransactionSpillEntry> spillEntries;     //oldest chunks, written to disk
+        vector<uint64_t> rollbackKeys;                  //entries of rollbackIndex owned by this transaction
         uint64_t opCodes;
         uint64_t pos;
         RedoLogRecord *lastRedoLogRecord1;
@@ -81,6 +95,8 @@ namespace OpenLogReplicator {
         void flushSplitBlocks(void);
         void flush(void);
         void updateLastRecord(void);
+        void addChunkRollbackKeys(TransactionChunk *tc);
+        void removeChunkRollbackKeys(TransactionChunk *tc);
         static bool matchesForRollback(RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2,
                 RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2);
         bool operator< (Transaction &p);
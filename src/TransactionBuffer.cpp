@@ -17,7 +17,9 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <fcntl.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "OracleAnalyser.h"
 #include "RedoLogRecord.h"
@@ -30,54 +32,71 @@ using namespace std;
 namespace OpenLogReplicator {
 
     TransactionBuffer::TransactionBuffer(OracleAnalyser *oracleAnalyser) :
-        oracleAnalyser(oracleAnalyser) {
+        oracleAnalyser(oracleAnalyser),
+        spilledTransactions(0) {
     }
 
     TransactionBuffer::~TransactionBuffer() {
-        if (partiallyFullChunks.size() > 0) {
-            RUNTIME_FAIL("non free blocks in transaction buffer: " << dec << partiallyFullChunks.size());
+        for (uint64_t sizeClass = 0; sizeClass < BUFFER_CLASSES; ++sizeClass) {
+            if (partiallyFullChunks[sizeClass].size() > 0) {
+                RUNTIME_FAIL("non free blocks in transaction buffer: " << dec << partiallyFullChunks[sizeClass].size() <<
+                        " of size " << dec << BUFFER_CLASS_SIZE(sizeClass));
+            }
         }
     }
 
-    TransactionChunk *TransactionBuffer::newTransactionChunk(void) {
+    //smallest buffer of at least given class which fits size bytes of data
+    TransactionChunk *TransactionBuffer::newTransactionChunk(uint64_t size, uint64_t sizeClass) {
         uint8_t *chunk;
         TransactionChunk *tc;
-        uint64_t pos, freeMap;
-        if (partiallyFullChunks.size() > 0) {
-            chunk = partiallyFullChunks.begin()->first;
-            freeMap = partiallyFullChunks.begin()->second;
-            pos = ffs(freeMap) - 1;
-            freeMap &= ~(1 << pos);
-            if (freeMap == 0)
-                partiallyFullChunks.erase(chunk);
-            else
-                partiallyFullChunks[chunk] = freeMap;
+        uint64_t pos;
+
+        while (sizeClass < BUFFER_CLASSES - 1 && BUFFER_CLASS_DATA_SIZE(sizeClass) < size)
+            ++sizeClass;
+
+        unordered_map<uint8_t*,TransactionBufferPage> &pages = partiallyFullChunks[sizeClass];
+        if (pages.size() > 0) {
+            chunk = pages.begin()->first;
+            TransactionBufferPage &page = pages.begin()->second;
+            uint64_t word = 0;
+            while (page.freeMap[word] == 0)
+                ++word;
+            pos = word * 64 + ffsll(page.freeMap[word]) - 1;
+            page.freeMap[word] &= ~(1ULL << (pos & 63));
+            --page.freeBuffers;
+            if (page.freeBuffers == 0)
+                pages.erase(chunk);
         } else {
             chunk = oracleAnalyser->getMemoryChunk("BUFFER", false);
+            TransactionBufferPage &page = pages[chunk];
+            for (uint64_t i = 1; i < BUFFERS_PER_PAGE(sizeClass); ++i)
+                page.freeMap[i >> 6] |= 1ULL << (i & 63);
+            page.freeBuffers = BUFFERS_PER_PAGE(sizeClass) - 1;
             pos = 0;
-            freeMap = BUFFERS_FREE_MASK & (~1);
-            partiallyFullChunks[chunk] = freeMap;
         }
 
-        tc = (TransactionChunk *)(chunk + FULL_BUFFER_SIZE * pos);
+        tc = (TransactionChunk *)(chunk + BUFFER_CLASS_SIZE(sizeClass) * pos);
         memset(tc, 0, HEADER_BUFFER_SIZE);
         tc->header = chunk;
         tc->pos = pos;
+        tc->sizeClass = sizeClass;
         return tc;
     }
 
     void TransactionBuffer::deleteTransactionChunk(TransactionChunk* tc) {
         uint8_t *chunk = tc->header;
         uint64_t pos = tc->pos;
-        uint64_t freeMap = partiallyFullChunks[chunk];
+        uint64_t sizeClass = tc->sizeClass;
+        //page with all buffers used is added back with empty map
+        TransactionBufferPage &page = partiallyFullChunks[sizeClass][chunk];
 
-        freeMap |= (1 << pos);
+        page.freeMap[pos >> 6] |= 1ULL << (pos & 63);
+        ++page.freeBuffers;
 
-        if (freeMap == BUFFERS_FREE_MASK) {
+        if (page.freeBuffers == BUFFERS_PER_PAGE(sizeClass)) {
             oracleAnalyser->freeMemoryChunk("BUFFER", chunk, false);
-            partiallyFullChunks.erase(chunk);
-        } else
-            partiallyFullChunks[chunk] = freeMap;
+            partiallyFullChunks[sizeClass].erase(chunk);
+        }
     }
 
     void TransactionBuffer::deleteTransactionChunks(TransactionChunk* tc) {
@@ -91,15 +110,18 @@ namespace OpenLogReplicator {
 
     void TransactionBuffer::addTransactionChunk(Transaction *transaction, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
 
-        if (redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL > DATA_BUFFER_SIZE) {
-            RUNTIME_FAIL(*oracleAnalyser <<  "block size (" << dec << (redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL)
+        uint64_t recordSize = redoLogRecord1->length + redoLogRecord2->length + ROW_FIELD_OFFSETS(redoLogRecord1, redoLogRecord2) + ROW_HEADER_TOTAL;
+
+        if (recordSize > DATA_BUFFER_SIZE) {
+            RUNTIME_FAIL(*oracleAnalyser <<  "block size (" << dec << recordSize
                     << ") exceeding max block size (" << FULL_BUFFER_SIZE << "), try increasing the FULL_BUFFER_SIZE parameter");
         }
 
         //empty list
         if (transaction->lastTc == nullptr) {
-            transaction->lastTc = newTransactionChunk();
+            transaction->lastTc = newTransactionChunk(recordSize, 0);
             transaction->firstTc = transaction->lastTc;
+            ++transaction->tcInMemory;
         } else
         if (transaction->lastTc->elements > 0) {
             uint64_t prevSize = *((uint64_t *)(transaction->lastTc->buffer + transaction->lastTc->size - ROW_HEADER_TOTAL + ROW_HEADER_SIZE));
@@ -122,8 +144,14 @@ namespace OpenLogReplicator {
                     ++elementsSkipped;
 
                     if (pos == 0) {
-                        if (tc->prev == nullptr)
+                        if (tc->prev == nullptr) {
+                            //older part of the transaction is spilled to disk
+                            if (transaction->spillEntries.size() > 0) {
+                                addSpilledTransactionChunk(transaction, redoLogRecord1, redoLogRecord2, recordSize);
+                                return;
+                            }
                             break;
+                        }
                         tc = tc->prev;
                         pos = tc->size;
                         elementsSkipped = 0;
@@ -143,8 +171,9 @@ namespace OpenLogReplicator {
 
                 if (pos < tc->size) {
                     //does the block need to be divided
-                    if (tc->size + redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL > DATA_BUFFER_SIZE) {
-                        TransactionChunk *tmpTc = newTransactionChunk();
+                    if (tc->size + recordSize > BUFFER_CLASS_DATA_SIZE(tc->sizeClass)) {
+                        TransactionChunk *tmpTc = newTransactionChunk(tc->size - pos, tc->sizeClass);
+                        ++transaction->tcInMemory;
 
                         tmpTc->elements = elementsSkipped;
                         tmpTc->size = tc->size - pos;
@@ -177,8 +206,9 @@ namespace OpenLogReplicator {
                 }
 
                 //new block needed
-                if (tc->size + redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL > DATA_BUFFER_SIZE) {
-                    TransactionChunk *tcNew = newTransactionChunk();
+                if (tc->size + recordSize > BUFFER_CLASS_DATA_SIZE(tc->sizeClass)) {
+                    TransactionChunk *tcNew = newTransactionChunk(recordSize, tc->sizeClass);
+                    ++transaction->tcInMemory;
                     tcNew->prev = tc;
                     tcNew->next = tc->next;
                     tc->next->prev = tcNew;
@@ -192,17 +222,110 @@ namespace OpenLogReplicator {
             }
         }
 
-        //new block needed
-        if (transaction->lastTc->size + redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL > DATA_BUFFER_SIZE) {
-            TransactionChunk *tcNew = newTransactionChunk();
+        //new block needed, the transaction grows so take bigger one
+        if (transaction->lastTc->size + recordSize > BUFFER_CLASS_DATA_SIZE(transaction->lastTc->sizeClass)) {
+            uint64_t sizeClass = transaction->lastTc->sizeClass;
+            if (sizeClass < BUFFER_CLASSES - 1)
+                ++sizeClass;
+            TransactionChunk *tcNew = newTransactionChunk(recordSize, sizeClass);
+            ++transaction->tcInMemory;
             tcNew->prev = transaction->lastTc;
             transaction->lastTc->next = tcNew;
             transaction->lastTc = tcNew;
+
+            if (oracleAnalyser->transactionSpillMb > 0)
+                spillTransactionChunks(transaction);
         }
         appendTransactionChunk(transaction->lastTc, redoLogRecord1, redoLogRecord2);
         transaction->updateLastRecord();
     }
 
+    //out of order row which belongs before the part of the transaction kept in memory
+    void TransactionBuffer::addSpilledTransactionChunk(Transaction *transaction, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2,
+            uint64_t recordSize) {
+        TransactionChunk *tc = nullptr;
+        uint64_t i = transaction->spillEntries.size();
+        uint64_t pos = 0;
+        uint64_t elementsSkipped = 0;
+
+        //locate correct position
+        while (i > 0) {
+            --i;
+            tc = readSpilledChunk(transaction, i);
+            pos = tc->size;
+            elementsSkipped = 0;
+
+            while (pos > 0) {
+                if (pos < ROW_HEADER_TOTAL || elementsSkipped >= tc->elements) {
+                    RUNTIME_FAIL(*oracleAnalyser << "bad data during finding SCN out of order in spilled chunk");
+                }
+                uint64_t prevSize = *((uint64_t *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SIZE));
+                typescn prevScn = *((typescn *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SCN));
+                typesubscn prevSubScn = *((typesubscn *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SUBSCN));
+
+                if ((prevScn < redoLogRecord1->scn ||
+                        ((prevScn == redoLogRecord1->scn && prevSubScn <= redoLogRecord1->subScn))))
+                    break;
+
+                if (pos < prevSize) {
+                    RUNTIME_FAIL(*oracleAnalyser << "trying move pos " << dec << pos << " back " << prevSize);
+                }
+                pos -= prevSize;
+                ++elementsSkipped;
+            }
+
+            if (pos > 0 || i == 0)
+                break;
+            deleteTransactionChunk(tc);
+        }
+
+        TRACE(TRACE2_TRANSACTION, "transaction " << PRINTXID(transaction->xid) << " out of order row added to spilled chunk " << dec << i);
+
+        if (tc->size + recordSize <= BUFFER_CLASS_DATA_SIZE(tc->sizeClass)) {
+            //copy to the middle of the block
+            uint64_t oldSize = tc->size - pos;
+            memcpy(buffer, tc->buffer + pos, oldSize);
+            tc->size = pos;
+            appendTransactionChunk(tc, redoLogRecord1, redoLogRecord2);
+            memcpy(tc->buffer + tc->size, buffer, oldSize);
+            tc->size += oldSize;
+            rewriteSpilledChunk(transaction, i, tc);
+            deleteTransactionChunk(tc);
+            return;
+        }
+
+        //the block needs to be divided, the new row and the rows after it are written as new entries
+        TransactionChunk *tailTc = nullptr;
+        if (pos < tc->size) {
+            tailTc = newTransactionChunk(tc->size - pos, 0);
+            tailTc->size = tc->size - pos;
+            tailTc->elements = elementsSkipped;
+            memcpy(tailTc->buffer, tc->buffer + pos, tailTc->size);
+            tc->size = pos;
+            tc->elements -= elementsSkipped;
+        }
+
+        TransactionChunk *rowTc = nullptr;
+        if (tc->size + recordSize <= BUFFER_CLASS_DATA_SIZE(tc->sizeClass))
+            appendTransactionChunk(tc, redoLogRecord1, redoLogRecord2);
+        else {
+            rowTc = newTransactionChunk(recordSize, 0);
+            appendTransactionChunk(rowTc, redoLogRecord1, redoLogRecord2);
+        }
+        rewriteSpilledChunk(transaction, i, tc);
+        deleteTransactionChunk(tc);
+
+        if (rowTc != nullptr) {
+            addSpillEntry(transaction, i + 1, rowTc);
+            deleteTransactionChunk(rowTc);
+            ++i;
+        }
+        if (tailTc != nullptr) {
+            addSpillEntry(transaction, i + 1, tailTc);
+            deleteTransactionChunk(tailTc);
+        }
+    }
+
     void TransactionBuffer::appendTransactionChunk(TransactionChunk* tc, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2) {
         //append to the chunk at the end
         *((typeop2 *)(tc->buffer + tc->size + ROW_HEADER_OP)) = (redoLogRecord1->opCode << 16) | redoLogRecord2->opCode;
@@ -211,14 +334,52 @@ namespace OpenLogReplicator {
         memcpy(tc->buffer + tc->size + ROW_HEADER_DATA, redoLogRecord1->data, redoLogRecord1->length);
         memcpy(tc->buffer + tc->size + ROW_HEADER_DATA + redoLogRecord1->length, redoLogRecord2->data, redoLogRecord2->length);
 
-        *((uint64_t *)(tc->buffer + tc->size + ROW_HEADER_SIZE + redoLogRecord1->length + redoLogRecord2->length)) = redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL;
-        *((typesubscn *)(tc->buffer + tc->size + ROW_HEADER_SUBSCN + redoLogRecord1->length + redoLogRecord2->length)) = redoLogRecord1->subScn;
-        *((typescn *)(tc->buffer + tc->size + ROW_HEADER_SCN + redoLogRecord1->length + redoLogRecord2->length)) = redoLogRecord1->scn;
+        //field offsets are built again for the stored copy, the pointer is set when the row is read
+        uint64_t dataSize = redoLogRecord1->length + redoLogRecord2->length;
+        uint16_t *fieldOffsets1 = (uint16_t *)(tc->buffer + tc->size + ROW_HEADER_DATA + dataSize);
+        uint16_t *fieldOffsets2 = (uint16_t *)(tc->buffer + tc->size + ROW_HEADER_DATA + dataSize + FIELD_OFFSETS_SIZE(redoLogRecord1->fieldCnt));
+        oracleAnalyser->buildFieldOffsets((RedoLogRecord *)(tc->buffer + tc->size + ROW_HEADER_REDO1), fieldOffsets1, redoLogRecord1->fieldCnt);
+        oracleAnalyser->buildFieldOffsets((RedoLogRecord *)(tc->buffer + tc->size + ROW_HEADER_REDO2), fieldOffsets2, redoLogRecord2->fieldCnt);
+        dataSize += ROW_FIELD_OFFSETS(redoLogRecord1, redoLogRecord2);
 
-        tc->size += redoLogRecord1->length + redoLogRecord2->length + ROW_HEADER_TOTAL;
+        *((uint64_t *)(tc->buffer + tc->size + ROW_HEADER_SIZE + dataSize)) = dataSize + ROW_HEADER_TOTAL;
+        *((typesubscn *)(tc->buffer + tc->size + ROW_HEADER_SUBSCN + dataSize)) = redoLogRecord1->subScn;
+        *((typescn *)(tc->buffer + tc->size + ROW_HEADER_SCN + dataSize)) = redoLogRecord1->scn;
+
+        tc->size += dataSize + ROW_HEADER_TOTAL;
         ++tc->elements;
     }
 
+    bool TransactionBuffer::deleteChunkPart(TransactionChunk* tc, RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2) {
+        uint64_t pos = tc->size;
+        int64_t left = tc->elements;
+
+        while (pos > 0) {
+            if (pos < ROW_HEADER_TOTAL || left <= 0) {
+                RUNTIME_FAIL(*oracleAnalyser << "error while deleting transaction part");
+            }
+
+            uint64_t lastSize = *((uint64_t *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SIZE));
+            RedoLogRecord *prevRedoLogRecord1 = (RedoLogRecord*)(tc->buffer + pos - lastSize + ROW_HEADER_REDO1);
+            RedoLogRecord *prevRedoLogRecord2 = (RedoLogRecord*)(tc->buffer + pos - lastSize + ROW_HEADER_REDO2);
+            //found match
+            if (Transaction::matchesForRollback(prevRedoLogRecord1, prevRedoLogRecord2, rollbackRedoLogRecord1, rollbackRedoLogRecord2)) {
+                if (pos < tc->size) {
+                    memcpy(buffer, tc->buffer + pos, tc->size - pos);
+                    memcpy(tc->buffer + pos - lastSize, buffer, tc->size - pos);
+                }
+                tc->size -= lastSize;
+                --tc->elements;
+                return true;
+            }
+
+            pos -= lastSize;
+            --left;
+        }
+
+        return false;
+    }
+
     bool TransactionBuffer::deleteTransactionPart(Transaction *transaction, RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2) {
         TransactionChunk *tc = transaction->lastTc;
         if (tc == nullptr || tc->size < ROW_HEADER_TOTAL || tc->elements == 0) {
@@ -226,45 +387,39 @@ namespace OpenLogReplicator {
         }
 
         while (tc != nullptr) {
-            uint64_t pos = tc->size;
-            int64_t left = tc->elements;
-
-            while (pos > 0) {
-                if (pos < ROW_HEADER_TOTAL || left <= 0) {
-                    RUNTIME_FAIL(*oracleAnalyser << "error while deleting transaction part");
+            if (deleteChunkPart(tc, rollbackRedoLogRecord1, rollbackRedoLogRecord2)) {
+                if (tc->elements == 0 && tc->next != nullptr) {
+                    tc->next->prev = tc->prev;
+                    if (tc->prev != nullptr)
+                        tc->prev->next = tc->next;
+                    else
+                        transaction->firstTc = tc->next;
+                    deleteTransactionChunk(tc);
+                    --transaction->tcInMemory;
                 }
+                if (tc == transaction->lastTc)
+                    transaction->updateLastRecord();
 
-                uint64_t lastSize = *((uint64_t *)(tc->buffer + pos - ROW_HEADER_TOTAL + ROW_HEADER_SIZE));
-                RedoLogRecord *prevRedoLogRecord1 = (RedoLogRecord*)(tc->buffer + pos - lastSize + ROW_HEADER_REDO1);
-                RedoLogRecord *prevRedoLogRecord2 = (RedoLogRecord*)(tc->buffer + pos - lastSize + ROW_HEADER_REDO2);
-                //found match
-                if (Transaction::matchesForRollback(prevRedoLogRecord1, prevRedoLogRecord2, rollbackRedoLogRecord1, rollbackRedoLogRecord2)) {
-                    if (pos < tc->size) {
-                        memcpy(buffer, tc->buffer + pos, tc->size - pos);
-                        memcpy(tc->buffer + pos - lastSize, buffer, tc->size - pos);
-                    }
-                    tc->size -= lastSize;
-
-                    --tc->elements;
-                    if (tc->elements == 0 && tc->next != nullptr) {
-                        tc->next->prev = tc->prev;
-                        if (tc->prev != nullptr)
-                            tc->prev->next = tc->next;
-                        else
-                            transaction->firstTc = tc->next;
-                        deleteTransactionChunk(tc);
-                    }
-                    if (tc == transaction->lastTc)
-                        transaction->updateLastRecord();
+                return true;
+            }
 
-                    return true;
-                }
+            tc = tc->prev;
+        }
 
-                pos -= lastSize;
-                --left;
+        //older part of the transaction is spilled to disk
+        for (uint64_t i = transaction->spillEntries.size(); i > 0; --i) {
+            tc = readSpilledChunk(transaction, i - 1);
+            bool found = deleteChunkPart(tc, rollbackRedoLogRecord1, rollbackRedoLogRecord2);
+            if (found) {
+                if (tc->elements == 0)
+                    transaction->spillEntries.erase(transaction->spillEntries.begin() + (i - 1));
+                else
+                    writeSpilledChunk(transaction, transaction->spillEntries[i - 1], tc);
             }
+            deleteTransactionChunk(tc);
 
-            tc = tc->prev;
+            if (found)
+                return true;
         }
 
         return false;
@@ -286,9 +441,25 @@ namespace OpenLogReplicator {
         if (transaction->lastTc->elements == 0) {
             TransactionChunk *tc = transaction->lastTc;
             transaction->lastTc = tc->prev;
+            --transaction->tcInMemory;
+
+            //bring back last spilled chunk, the tail of the transaction is always in memory
+            if (transaction->lastTc == nullptr && transaction->spillEntries.size() > 0) {
+                transaction->lastTc = readSpilledChunk(transaction, transaction->spillEntries.size() - 1);
+                transaction->spillEntries.pop_back();
+                //entries moved after growing are not in file order
+                transaction->spillSize = 0;
+                for (TransactionSpillEntry &entry : transaction->spillEntries)
+                    if (transaction->spillSize < entry.offset + entry.size)
+                        transaction->spillSize = entry.offset + entry.size;
+                ++transaction->tcInMemory;
+                transaction->addChunkRollbackKeys(transaction->lastTc);
+            }
 
             if (transaction->lastTc != nullptr) {
                 transaction->lastTc->next = nullptr;
+                if (transaction->lastTc->prev == nullptr)
+                    transaction->firstTc = transaction->lastTc;
                 transaction->updateLastRecord();
             } else {
                 transaction->firstTc = nullptr;
@@ -299,4 +470,91 @@ namespace OpenLogReplicator {
         } else
             transaction->updateLastRecord();
     }
+
+    //oldest chunks of the transaction are moved to an append-only file
+    void TransactionBuffer::spillTransactionChunks(Transaction *transaction) {
+        uint64_t keep = oracleAnalyser->transactionSpillMb * 1024 * 1024 / FULL_BUFFER_SIZE;
+        if (transaction->tcInMemory <= keep) {
+            if (transaction->tcInMemory <= SPILL_CHUNKS_KEEP || !oracleAnalyser->memoryLow())
+                return;
+            keep = SPILL_CHUNKS_KEEP;
+        }
+        if (keep < SPILL_CHUNKS_KEEP)
+            keep = SPILL_CHUNKS_KEEP;
+
+        if (transaction->spillFd == -1) {
+            stringstream name;
+            name << oracleAnalyser->databaseContext << "-" << setfill('0') << setw(16) << hex << transaction->xid << ".spill";
+            transaction->spillFd = open(name.str().c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+            if (transaction->spillFd == -1) {
+                RUNTIME_FAIL("can't create transaction spill file: " << name.str() << " - " << strerror(errno));
+            }
+            //file is removed when closed
+            unlink(name.str().c_str());
+            transaction->spillSize = 0;
+            ++spilledTransactions;
+            TRACE(TRACE2_TRANSACTION, "transaction " << PRINTXID(transaction->xid) << " spilled to disk");
+        }
+
+        while (transaction->tcInMemory > keep) {
+            TransactionChunk *tc = transaction->firstTc;
+            addSpillEntry(transaction, transaction->spillEntries.size(), tc);
+            transaction->removeChunkRollbackKeys(tc);
+
+            transaction->firstTc = tc->next;
+            transaction->firstTc->prev = nullptr;
+            deleteTransactionChunk(tc);
+            --transaction->tcInMemory;
+        }
+    }
+
+    //new entries are appended at the end of the file, entry order keeps the order of rows
+    void TransactionBuffer::addSpillEntry(Transaction *transaction, uint64_t i, TransactionChunk *tc) {
+        TransactionSpillEntry entry;
+        entry.offset = transaction->spillSize;
+        writeSpilledChunk(transaction, entry, tc);
+        transaction->spillEntries.insert(transaction->spillEntries.begin() + i, entry);
+        transaction->spillSize += tc->size;
+    }
+
+    void TransactionBuffer::rewriteSpilledChunk(Transaction *transaction, uint64_t i, TransactionChunk *tc) {
+        TransactionSpillEntry &entry = transaction->spillEntries[i];
+        //grown chunk would overwrite the next one, move it to the end of the file
+        if (tc->size > entry.size) {
+            entry.offset = transaction->spillSize;
+            transaction->spillSize += tc->size;
+        }
+        writeSpilledChunk(transaction, entry, tc);
+    }
+
+    void TransactionBuffer::writeSpilledChunk(Transaction *transaction, TransactionSpillEntry &entry, TransactionChunk *tc) {
+        //chunk is written in place, it must not grow over the next entry
+        if (pwrite(transaction->spillFd, tc->buffer, tc->size, entry.offset) != (int64_t)tc->size) {
+            RUNTIME_FAIL("writing transaction spill file for xid: " << PRINTXID(transaction->xid) << " - " << strerror(errno));
+        }
+        entry.size = tc->size;
+        entry.elements = tc->elements;
+    }
+
+    TransactionChunk *TransactionBuffer::readSpilledChunk(Transaction *transaction, uint64_t i) {
+        TransactionSpillEntry &entry = transaction->spillEntries[i];
+        TransactionChunk *tc = newTransactionChunk(entry.size, 0);
+
+        if (pread(transaction->spillFd, tc->buffer, entry.size, entry.offset) != (int64_t)entry.size) {
+            RUNTIME_FAIL("reading transaction spill file for xid: " << PRINTXID(transaction->xid) << " - " << strerror(errno));
+        }
+        tc->size = entry.size;
+        tc->elements = entry.elements;
+        return tc;
+    }
+
+    void TransactionBuffer::deleteTransactionSpill(Transaction *transaction) {
+        if (transaction->spillFd != -1) {
+            close(transaction->spillFd);
+            transaction->spillFd = -1;
+            --spilledTransactions;
+        }
+        transaction->spillEntries.clear();
+        transaction->spillSize = 0;
+    }
 }
@@ -18,6 +18,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
 #include <unordered_map>
+#include <vector>
 
 #include "types.h"
 
@@ -32,12 +33,19 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define ROW_HEADER_SUBSCN   (sizeof(typeop2)+sizeof(struct RedoLogRecord)+sizeof(struct RedoLogRecord)+sizeof(uint64_t))
 #define ROW_HEADER_SCN      (sizeof(typeop2)+sizeof(struct RedoLogRecord)+sizeof(struct RedoLogRecord)+sizeof(uint64_t)+sizeof(uint32_t))
 #define ROW_HEADER_TOTAL    (sizeof(typeop2)+sizeof(struct RedoLogRecord)+sizeof(struct RedoLogRecord)+sizeof(uint64_t)+sizeof(uint32_t)+sizeof(typescn))
+//field offsets tables of both records follow the data, before size/subscn/scn
+#define ROW_FIELD_OFFSETS(r1,r2)    (FIELD_OFFSETS_SIZE((r1)->fieldCnt)+FIELD_OFFSETS_SIZE((r2)->fieldCnt))
 
 #define FULL_BUFFER_SIZE    65536
-#define HEADER_BUFFER_SIZE  (sizeof(uint64_t)+sizeof(uint64_t)+sizeof(uint64_t)+sizeof(uint8_t*)+sizeof(TransactionChunk*)+sizeof(TransactionChunk*))
+#define HEADER_BUFFER_SIZE  (sizeof(uint64_t)+sizeof(uint64_t)+sizeof(uint64_t)+sizeof(uint64_t)+sizeof(uint8_t*)+sizeof(TransactionChunk*)+sizeof(TransactionChunk*))
 #define DATA_BUFFER_SIZE    (FULL_BUFFER_SIZE-HEADER_BUFFER_SIZE)
-#define BUFFERS_PER_PAGE    (MEMORY_CHUNK_SIZE_MB*1024*1024/FULL_BUFFER_SIZE)
-#define BUFFERS_FREE_MASK   0xFFFF
+//size classes: 4kB, 16kB, 64kB - next chunk of a growing transaction is one class bigger
+#define BUFFER_CLASSES      3
+#define BUFFER_CLASS_SIZE(c)        (((uint64_t)FULL_BUFFER_SIZE)>>(2*(BUFFER_CLASSES-1-(c))))
+#define BUFFER_CLASS_DATA_SIZE(c)   (BUFFER_CLASS_SIZE(c)-HEADER_BUFFER_SIZE)
+#define BUFFERS_PER_PAGE(c) (MEMORY_CHUNK_SIZE_MB*1024*1024/BUFFER_CLASS_SIZE(c))
+#define BUFFERS_MAP_WORDS   (BUFFERS_PER_PAGE(0)/64)
+#define SPILL_CHUNKS_KEEP   2
 
 namespace OpenLogReplicator {
 
@@ -50,10 +58,29 @@ namespace OpenLogReplicator {
         uint64_t elements;
         uint64_t size;
         uint64_t pos;
+        uint64_t sizeClass;
         uint8_t *header;
         TransactionChunk *prev;
         TransactionChunk *next;
-        uint8_t buffer[DATA_BUFFER_SIZE];
+        uint8_t buffer[DATA_BUFFER_SIZE];   //only BUFFER_CLASS_DATA_SIZE(sizeClass) bytes are usable
+    };
+
+    //memory chunk divided into buffers of one size class, not present on the list when all buffers are used
+    struct TransactionBufferPage {
+        uint64_t freeBuffers;
+        uint64_t freeMap[BUFFERS_MAP_WORDS];
+    };
+
+    //chunk payload written to transaction spill file
+    struct TransactionSpillEntry {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t elements;
+    };
+
+    struct RollbackIndexEntry {
+        typexid xid;                    //owning transaction
+        uint64_t pos;                   //position in Transaction::rollbackKeys
     };
 
     class TransactionBuffer {
@@ -62,19 +89,29 @@ namespace OpenLogReplicator {
         uint8_t buffer[DATA_BUFFER_SIZE];
 
         void appendTransactionChunk(TransactionChunk* tc, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
+        bool deleteChunkPart(TransactionChunk* tc, RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2);
+        void spillTransactionChunks(Transaction *transaction);
+        void addSpilledTransactionChunk(Transaction *transaction, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2,
+                uint64_t recordSize);
+        void addSpillEntry(Transaction *transaction, uint64_t i, TransactionChunk *tc);
+        void rewriteSpilledChunk(Transaction *transaction, uint64_t i, TransactionChunk *tc);
+        void writeSpilledChunk(Transaction *transaction, TransactionSpillEntry &entry, TransactionChunk *tc);
 
     public:
-        unordered_map<uint8_t*,uint64_t> partiallyFullChunks;
+        unordered_map<uint8_t*,TransactionBufferPage> partiallyFullChunks[BUFFER_CLASSES];
+        uint64_t spilledTransactions;
 
         TransactionBuffer(OracleAnalyser *oracleAnalyser);
         virtual ~TransactionBuffer();
 
-        TransactionChunk* newTransactionChunk(void);
+        TransactionChunk* newTransactionChunk(uint64_t size, uint64_t sizeClass);
         void addTransactionChunk(Transaction *transaction, RedoLogRecord *redoLogRecord1, RedoLogRecord *redoLogRecord2);
         void rollbackTransactionChunk(Transaction *transaction);
         bool deleteTransactionPart(Transaction *transaction, RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2);
         void deleteTransactionChunk(TransactionChunk* tc);
         void deleteTransactionChunks(TransactionChunk* tc);
+        TransactionChunk* readSpilledChunk(Transaction *transaction, uint64_t i);
+        void deleteTransactionSpill(Transaction *transaction);
     };
 }
 
@@ -32,13 +32,26 @@ namespace OpenLogReplicator {
     TransactionMap::TransactionMap(OracleAnalyser *oracleAnalyser, uint64_t maps) :
         oracleAnalyser(oracleAnalyser),
         maps(0),
-        elements(0) {
-
-        for (uint64_t i = 0; i < maps; ++i) {
+        baseBuckets(0),
+        splitPos(0),
+        elements(0),
+        buckets(0),
+        chainMax(0),
+        lookups(0),
+        lookupSteps(0) {
+
+        //bucket number must be a power of 2 for linear hashing
+        uint64_t mapsInitial = 1;
+        while (mapsInitial * 2 <= maps)
+            mapsInitial *= 2;
+
+        for (uint64_t i = 0; i < mapsInitial; ++i) {
             hashMapList[i] = (Transaction **)oracleAnalyser->getMemoryChunk("MAP", false);
             memset(hashMapList[i], 0, MEMORY_CHUNK_SIZE);
             ++this->maps;
         }
+        baseBuckets = this->maps * MAPS_IN_CHUNK;
+        buckets = baseBuckets;
     }
 
     TransactionMap::~TransactionMap() {
@@ -46,41 +59,98 @@ namespace OpenLogReplicator {
             oracleAnalyser->freeMemoryChunk("MAP", (uint8_t*)hashMapList[--maps], false);
     }
 
+    uint64_t TransactionMap::hashKey(typeuba uba, typeslt slt, typerci rci) {
+        uint64_t hash = uba ^ ((uint64_t)slt << 48) ^ ((uint64_t)rci << 56);
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    uint64_t TransactionMap::bucket(uint64_t hash) {
+        uint64_t pos = hash & (baseBuckets - 1);
+        if (pos < splitPos)
+            pos = hash & (baseBuckets * 2 - 1);
+        return pos;
+    }
+
+    //move one bucket to its new position, the cost of growing is spread over many inserts
+    void TransactionMap::split(void) {
+        uint64_t newPos = baseBuckets + splitPos;
+        if (newPos >= MAPS_MAX * MAPS_IN_CHUNK)
+            return;
+
+        if ((newPos % MAPS_IN_CHUNK) == 0) {
+            if (oracleAnalyser->memoryLow())
+                return;
+            hashMapList[maps] = (Transaction **)oracleAnalyser->getMemoryChunk("MAP", false);
+            memset(hashMapList[maps], 0, MEMORY_CHUNK_SIZE);
+            ++maps;
+        }
+
+        Transaction *transactionTmp = MAP_AT(splitPos);
+        MAP_AT(splitPos) = nullptr;
+        while (transactionTmp != nullptr) {
+            Transaction *transactionNext = transactionTmp->next;
+            uint64_t pos = hashKey(transactionTmp->lastRedoLogRecord1->uba, transactionTmp->lastRedoLogRecord1->slt,
+                    transactionTmp->lastRedoLogRecord1->rci) & (baseBuckets * 2 - 1);
+            transactionTmp->next = MAP_AT(pos);
+            MAP_AT(pos) = transactionTmp;
+            transactionTmp = transactionNext;
+        }
+
+        ++buckets;
+        ++splitPos;
+        if (splitPos == baseBuckets) {
+            baseBuckets *= 2;
+            splitPos = 0;
+        }
+    }
+
     void TransactionMap::set(Transaction* transaction) {
         if (transaction->lastRedoLogRecord1 == nullptr) {
             RUNTIME_FAIL("trying to set empty last record in transaction map");
         }
 
-        uint64_t hashKey = HASHINGFUNCTION(transaction->lastRedoLogRecord1->uba, transaction->lastRedoLogRecord1->slt,
-                transaction->lastRedoLogRecord1->rci);
+        if (elements >= buckets * MAP_LOAD_MAX)
+            split();
+
+        uint64_t pos = bucket(hashKey(transaction->lastRedoLogRecord1->uba, transaction->lastRedoLogRecord1->slt,
+                transaction->lastRedoLogRecord1->rci));
 
-        Transaction *transactionTmp = MAP_AT(hashKey);
+        uint64_t chain = 1;
+        Transaction *transactionTmp = MAP_AT(pos);
         while (transactionTmp != nullptr) {
             if (transactionTmp == transaction) {
                 RUNTIME_FAIL("transaction already present in hash map");
             }
             transactionTmp = transactionTmp->next;
+            ++chain;
         }
+        if (chain > chainMax)
+            chainMax = chain;
 
-        transaction->next = MAP_AT(hashKey);
-        MAP_AT(hashKey) = transaction;
+        transaction->next = MAP_AT(pos);
+        MAP_AT(pos) = transaction;
         ++elements;
     }
 
     void TransactionMap::erase(Transaction * transaction) {
-        uint64_t hashKey = HASHINGFUNCTION(transaction->lastRedoLogRecord1->uba, transaction->lastRedoLogRecord1->slt,
-                transaction->lastRedoLogRecord1->rci);
+        uint64_t pos = bucket(hashKey(transaction->lastRedoLogRecord1->uba, transaction->lastRedoLogRecord1->slt,
+                transaction->lastRedoLogRecord1->rci));
 
-        if (MAP_AT(hashKey) == nullptr) {
+        if (MAP_AT(pos) == nullptr) {
             RUNTIME_FAIL("transaction does not exist in hash map1, codes: " << dec << transaction->opCodes <<
                     ", UBA: " << PRINTUBA(transaction->lastRedoLogRecord1->uba) <<
                     ", SLT: " << (uint64_t)transaction->lastRedoLogRecord1->slt <<
                     ", RCI: " << transaction->lastRedoLogRecord1->rci);
         }
 
-        Transaction *transactionTmp = MAP_AT(hashKey);
+        Transaction *transactionTmp = MAP_AT(pos);
         if (transactionTmp == transaction) {
-            MAP_AT(hashKey) = transactionTmp->next;
+            MAP_AT(pos) = transactionTmp->next;
             transactionTmp->next = nullptr;
             --elements;
             return;
@@ -105,10 +175,12 @@ namespace OpenLogReplicator {
 
     //typeuba uba, typedba dba, typeslt slt, typerci rci, typescn scn, uint64_t opFlags
     Transaction* TransactionMap::getMatchForRollback(RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2) {
-        uint64_t hashKey = HASHINGFUNCTION(rollbackRedoLogRecord1->uba, rollbackRedoLogRecord2->slt, rollbackRedoLogRecord2->rci);
-        Transaction *transactionTmp = MAP_AT(hashKey);
+        uint64_t pos = bucket(hashKey(rollbackRedoLogRecord1->uba, rollbackRedoLogRecord2->slt, rollbackRedoLogRecord2->rci));
+        Transaction *transactionTmp = MAP_AT(pos);
 
+        ++lookups;
         while (transactionTmp != nullptr) {
+            ++lookupSteps;
             if (Transaction::matchesForRollback(transactionTmp->lastRedoLogRecord1, transactionTmp->lastRedoLogRecord2,
                     rollbackRedoLogRecord1, rollbackRedoLogRecord2))
                 return transactionTmp;
@@ -118,4 +190,8 @@ namespace OpenLogReplicator {
 
         return nullptr;
     }
+
+    double TransactionMap::loadFactor(void) {
+        return (double)elements / buckets;
+    }
 }
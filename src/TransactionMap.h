@@ -22,10 +22,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef TRANSACTIONMAP_H_
 #define TRANSACTIONMAP_H_
 
-#define HASHINGFUNCTION(uba,slt,rci) ((uba^((uint64_t)slt<<9)^((uint64_t)rci<<37))%((maps*MEMORY_CHUNK_SIZE_MB*1024*1024/sizeof(Transaction*))-1))
 #define MAPS_MAX (MAX_TRANSACTIONS_LIMIT*2*sizeof(Transaction*)/(MEMORY_CHUNK_SIZE_MB*1024*1024))
 #define MAPS_IN_CHUNK (1024*1024/sizeof(Transaction*))
 #define MAP_AT(a) hashMapList[(a)/MAPS_IN_CHUNK][(a)%MAPS_IN_CHUNK]
+#define MAP_LOAD_MAX 1
 
 namespace OpenLogReplicator {
     class OracleAnalyser;
@@ -36,16 +36,29 @@ namespace OpenLogReplicator {
     protected:
         OracleAnalyser *oracleAnalyser;
         uint64_t maps;
-        uint64_t elements;
         Transaction** hashMapList[MAPS_MAX];
+        //linear hashing: buckets below splitPos are already split into baseBuckets*2
+        uint64_t baseBuckets;
+        uint64_t splitPos;
+
+        uint64_t hashKey(typeuba uba, typeslt slt, typerci rci);
+        uint64_t bucket(uint64_t hash);
+        void split(void);
 
     public:
+        uint64_t elements;
+        uint64_t buckets;
+        uint64_t chainMax;                  //longest chain seen while adding
+        uint64_t lookups;
+        uint64_t lookupSteps;
+
         TransactionMap(OracleAnalyser *oracleAnalyser, uint64_t maps);
         virtual ~TransactionMap();
 
         void erase(Transaction * transaction);
         void set(Transaction * transaction);
         Transaction* getMatchForRollback(RedoLogRecord *rollbackRedoLogRecord1, RedoLogRecord *rollbackRedoLogRecord2);
+        double loadFactor(void);
     };
 }
 
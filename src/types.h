@@ -146,6 +146,12 @@ typedef uint64_t typeunicode;
 #define REDO_FLAGS_BLOCK_CHECK_SUM              0x0000040
 #define REDO_FLAGS_HIDE_INVISIBLE_COLUMNS       0x0000080
 #define REDO_FLAGS_INCOMPLETE_TRANSACTIONS      0x0000100
+#define REDO_FLAGS_ARCH_MMAP                    0x0000200
+#define REDO_FLAGS_VERIFY_LAST_BLOCK            0x0000400
+#define REDO_FLAGS_NOTIFY                       0x0000800
+#define REDO_FLAGS_INDEX                        0x0001000
+#define REDO_FLAGS_ASSEMBLY_THREAD              0x0002000
+#define REDO_FLAGS_DUMP_BINARY                  0x0004000
 
 #define DISABLE_CHECK_GRANTS                    0x0000001
 #define DISABLE_CHECK_SUPPLEMENTAL_LOG          0x0000002